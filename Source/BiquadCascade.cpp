@@ -0,0 +1,84 @@
+#include "BiquadCascade.h"
+#include <algorithm>
+#include <cassert>
+
+template <typename SampleType>
+BiquadCascade<SampleType>::BiquadCascade()
+{
+    // Sections transparentes par défaut, comme juce::dsp::IIR::Filter
+    for (int k = 0; k < numSections; ++k)
+        setCoefficients(k, {});
+    prepare(2);
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::prepare(int numChannels)
+{
+    groups.resize((size_t) ((std::max(1, numChannels) + groupSize - 1) / groupSize));
+    reset();
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::setCoefficients(int section, const BasicBiquadCoefficients<SampleType>& c)
+{
+    assert(section >= 0 && section < numSections);
+    auto& s = sections[(size_t) section];
+    s.b0 = Vec::expand(c.b0);
+    s.b1 = Vec::expand(c.b1);
+    s.b2 = Vec::expand(c.b2);
+    s.a1 = Vec::expand(c.a1);
+    s.a2 = Vec::expand(c.a2);
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::reset()
+{
+    for (auto& g : groups)
+        for (auto& s : g) {
+            s.s1 = Vec::expand((SampleType) 0);
+            s.s2 = Vec::expand((SampleType) 0);
+        }
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::process(SampleType* const* channels, int numChannels, int numSamples)
+{
+    assert(numChannels <= (int) groups.size() * groupSize);
+    numChannels = std::min(numChannels, (int) groups.size() * groupSize);
+
+    for (int first = 0, g = 0; first < numChannels; first += groupSize, ++g)
+        processGroup(groups[(size_t) g], channels + first, std::min(groupSize, numChannels - first), numSamples);
+}
+
+template <typename SampleType>
+void BiquadCascade<SampleType>::processGroup(GroupState& state, SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    // Copies locales des coefficients et de l'état : restent en registres pendant la boucle
+    const auto coeffs = sections;
+    auto st = state;
+    alignas(16 * sizeof(float)) SampleType frame[Vec::SIMDNumElements] = {};
+
+    for (int i = 0; i < numSamples; ++i) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            frame[ch] = channels[ch][i];
+
+        auto x = Vec::fromRawArray(frame);
+        for (size_t k = 0; k < coeffs.size(); ++k) {
+            const auto& c = coeffs[k];
+            auto& s = st[k];
+            auto y = c.b0 * x + s.s1;
+            s.s1 = c.b1 * x - c.a1 * y + s.s2;
+            s.s2 = c.b2 * x - c.a2 * y;
+            x = y;
+        }
+        x.copyToRawArray(frame);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch][i] = frame[ch];
+    }
+
+    state = st;
+}
+
+template class BiquadCascade<float>;
+template class BiquadCascade<double>;
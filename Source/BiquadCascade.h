@@ -0,0 +1,54 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "SIMDVector.h"
+
+// Coefficients biquad normalisés (a0 = 1), même ordre que juce::dsp::IIR::Coefficients : b0, b1, b2, a1, a2
+template <typename SampleType>
+struct BasicBiquadCoefficients
+{
+    SampleType b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+};
+
+using BiquadCoefficients = BasicBiquadCoefficients<float>;
+using PreciseBiquadCoefficients = BasicBiquadCoefficients<double>;
+
+// Cascade fusionnée des 3 sections de l'EQ (low shelf, mid peak, high shelf).
+// Une seule passe par échantillon ; les canaux sont traités par groupes de
+// groupSize (float : 4 en SSE/NEON, 8 en AVX ; double : moitié moins), un canal
+// par lane d'un registre SIMD : un bus 7.1.4 coûte 3 groupes, comme 3 instances stéréo.
+// (transposée directe forme II, même structure que juce::dsp::IIR::Filter)
+template <typename SampleType>
+class BiquadCascade
+{
+public:
+    using Vec = SIMDVector<SampleType>;
+    static constexpr int numSections = 3;
+    static constexpr int groupSize = (int) Vec::SIMDNumElements;
+
+    BiquadCascade();
+
+    // Alloue l'état pour numChannels canaux (hors thread audio)
+    void prepare(int numChannels);
+    void setCoefficients(int section, const BasicBiquadCoefficients<SampleType>& c);
+    void reset();
+    void process(SampleType* const* channels, int numChannels, int numSamples);
+
+private:
+    struct Section
+    {
+        Vec b0, b1, b2, a1, a2;
+    };
+
+    struct State
+    {
+        Vec s1, s2;
+    };
+
+    using GroupState = std::array<State, numSections>;
+
+    void processGroup(GroupState& state, SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    std::array<Section, numSections> sections;
+    std::vector<GroupState> groups;
+};
@@ -0,0 +1,118 @@
+#include "CoefficientTable.h"
+
+namespace
+{
+    constexpr double commonRates[] = { 44100.0, 48000.0, 88200.0, 96000.0 };
+
+    constexpr int numShelfGains = (int) ((CoefficientTable::maxGainDb - CoefficientTable::minGainDb) * CoefficientTable::shelfStepsPerDb) + 1;
+    constexpr int numPeakGains = (int) ((CoefficientTable::maxGainDb - CoefficientTable::minGainDb) * CoefficientTable::peakStepsPerDb) + 1;
+
+    const double qScale = (CoefficientTable::numQ - 1) / std::log((double) CoefficientTable::maxQ / CoefficientTable::minQ);
+
+    BiquadCoefficients lerp(const BiquadCoefficients& a, const BiquadCoefficients& b, float t) noexcept
+    {
+        // Combinaison convexe de deux biquads stables : (a1, a2) reste dans le triangle de stabilité
+        return { a.b0 + t * (b.b0 - a.b0), a.b1 + t * (b.b1 - a.b1), a.b2 + t * (b.b2 - a.b2),
+                 a.a1 + t * (b.a1 - a.a1), a.a2 + t * (b.a2 - a.a2) };
+    }
+
+    // Position dans la grille : index entier et fraction (t = 0 exactement sur un point)
+    void locate(float x, int size, int& index, float& t) noexcept
+    {
+        index = juce::jlimit(0, size - 2, (int) x);
+        t = x - (float) index;
+    }
+}
+
+CoefficientTable::CoefficientTable()
+{
+    for (auto& slot : ready)
+        slot.store(nullptr);
+    for (auto rate : commonRates)
+        prepare(rate);
+}
+
+void CoefficientTable::prepare(double sampleRate)
+{
+    const juce::ScopedLock sl(lock);
+    for (auto& t : requested)
+        if (t->sampleRate == sampleRate)
+            return;
+    if ((int) requested.size() >= maxRates)
+        return; // plus de place : conception directe pour cette fréquence
+
+    requested.push_back(std::make_unique<RateTables>());
+    auto* tables = requested.back().get();
+    tables->sampleRate = sampleRate;
+
+    builder.addJob([this, tables] {
+        build(*tables);
+        const juce::ScopedLock publishLock(lock);
+        ready[(size_t) numReady++].store(tables);
+    });
+}
+
+void CoefficientTable::build(RateTables& t)
+{
+    const auto rate = t.sampleRate;
+    t.lowShelf.resize((size_t) numShelfGains);
+    t.highShelf.resize((size_t) numShelfGains);
+    t.peak.resize((size_t) (numPeakGains * numQ));
+
+    // Gains calculés depuis l'index entier : le point 0 dB tombe exactement sur 0
+    for (int i = 0; i < numShelfGains; ++i) {
+        EQParameters p;
+        p.lowGain = p.highGain = (float) (minGainDb + (double) i / shelfStepsPerDb);
+        t.lowShelf[(size_t) i] = EQDesign::makeBand(EQBands::low, rate, p);
+        t.highShelf[(size_t) i] = EQDesign::makeBand(EQBands::high, rate, p);
+    }
+
+    for (int q = 0; q < numQ; ++q) {
+        for (int i = 0; i < numPeakGains; ++i) {
+            EQParameters p;
+            p.midGain = (float) (minGainDb + (double) i / peakStepsPerDb);
+            p.midQ = (float) (minQ * std::exp(q / qScale));
+            t.peak[(size_t) (q * numPeakGains + i)] = EQDesign::makeBand(EQBands::mid, rate, p);
+        }
+    }
+}
+
+const CoefficientTable::RateTables* CoefficientTable::find(double sampleRate) const noexcept
+{
+    for (auto& slot : ready) {
+        auto* t = slot.load(std::memory_order_acquire);
+        if (t == nullptr)
+            break;
+        if (t->sampleRate == sampleRate)
+            return t;
+    }
+    return nullptr;
+}
+
+BiquadCoefficients CoefficientTable::makeBand(int band, double sampleRate, const EQParameters& p) const noexcept
+{
+    const auto* t = find(sampleRate);
+    const float gain = band == EQBands::low ? p.lowGain : band == EQBands::mid ? p.midGain : p.highGain;
+    const bool inRange = gain >= minGainDb && gain <= maxGainDb
+                      && (band != EQBands::mid || (p.midQ >= minQ && p.midQ <= maxQ));
+
+    if (t == nullptr || !inRange)
+        return EQDesign::makeBand(band, sampleRate, p);
+
+    int i;
+    float tg;
+    if (band != EQBands::mid) {
+        const auto& shelf = band == EQBands::low ? t->lowShelf : t->highShelf;
+        locate((gain - minGainDb) * shelfStepsPerDb, numShelfGains, i, tg);
+        return lerp(shelf[(size_t) i], shelf[(size_t) i + 1], tg);
+    }
+
+    int j;
+    float tq;
+    locate((gain - minGainDb) * peakStepsPerDb, numPeakGains, i, tg);
+    locate((float) (std::log((double) p.midQ / minQ) * qScale), numQ, j, tq);
+
+    const auto* row0 = t->peak.data() + j * numPeakGains;
+    const auto* row1 = row0 + numPeakGains;
+    return lerp(lerp(row0[i], row0[i + 1], tg), lerp(row1[i], row1[i + 1], tg), tq);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+#include "EQCoefficients.h"
+
+// Tables de coefficients biquad partagées par toutes les instances du process
+// (juce::SharedResourcePointer), une par fréquence d'échantillonnage.
+// Shelves : gain quantifié à 0.01 dB ; peak : 0.05 dB x 64 valeurs de Q log-réparties.
+// Lecture interpolée entre les points voisins, sans verrou ni allocation.
+// Les fréquences courantes sont construites en tâche de fond dès la première instance,
+// les autres au premier prepare() ; en attendant, conception directe.
+class CoefficientTable
+{
+public:
+    // Mêmes bornes que les paramètres du plugin
+    static constexpr float minGainDb = EQBands::minGainDb, maxGainDb = EQBands::maxGainDb;
+    static constexpr float minQ = EQBands::minQ, maxQ = EQBands::maxQ;
+    static constexpr int shelfStepsPerDb = 100;
+    static constexpr int peakStepsPerDb = 20;
+    static constexpr int numQ = 64;
+
+    CoefficientTable();
+
+    // Demande la table de cette fréquence (construite en tâche de fond si absente)
+    void prepare(double sampleRate);
+
+    // Lecture dans la table si elle est prête et les paramètres dans les bornes,
+    // sinon EQDesign::makeBand. Appelable depuis n'importe quel thread.
+    BiquadCoefficients makeBand(int band, double sampleRate, const EQParameters& params) const noexcept;
+
+    // Table de cette fréquence construite (sinon makeBand conçoit directement)
+    bool isReady(double sampleRate) const noexcept { return find(sampleRate) != nullptr; }
+
+private:
+    struct RateTables
+    {
+        double sampleRate = 0.0;
+        std::vector<BiquadCoefficients> lowShelf, highShelf;   // [gain]
+        std::vector<BiquadCoefficients> peak;                  // [q][gain]
+    };
+
+    static constexpr int maxRates = 8;
+    static void build(RateTables& tables);
+    const RateTables* find(double sampleRate) const noexcept;
+
+    std::array<std::atomic<const RateTables*>, maxRates> ready;
+
+    juce::CriticalSection lock;                       // requested / numReady (thread de message et builder)
+    std::vector<std::unique_ptr<RateTables>> requested;
+    int numReady = 0;
+    juce::ThreadPool builder { 1 };                   // détruit en premier : attend le job en cours
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CoefficientTable)
+};
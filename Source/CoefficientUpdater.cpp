@@ -0,0 +1,198 @@
+#include "CoefficientUpdater.h"
+
+namespace
+{
+    constexpr int allBands = (1 << EQBands::numBands) - 1;
+    constexpr int maxIdleWaitMs = 20;   // automation du thread audio, qui ne réveille pas le thread
+    const char* const designParameterIDs[] = { "LowGain", "MidGain", "HighGain", "MidQ" };
+}
+
+// Thread unique pour tout le process : il sonde les instances enregistrées et
+// ne travaille que pour celles dont un paramètre a bougé. Réveillé par notify() quand
+// un changement vient d'ailleurs que du thread audio ; sinon, au repos, il espace ses
+// passages jusqu'à maxIdleWaitMs et revient à 1 ms dès qu'une instance a du travail.
+struct CoefficientUpdater::DesignThread : public juce::Thread
+{
+    DesignThread() : juce::Thread("MerjEQ coefficient designer") { startThread(); }
+    ~DesignThread() override { stopThread(1000); }
+
+    void add(CoefficientUpdater* u)
+    {
+        const juce::ScopedLock sl(lock);
+        clients.addIfNotAlreadyThere(u);
+    }
+
+    void remove(CoefficientUpdater* u)
+    {
+        const juce::ScopedLock sl(lock);
+        clients.removeFirstMatchingValue(u);
+    }
+
+    void run() override
+    {
+        int waitMs = 1;
+        while (!threadShouldExit()) {
+            bool busy = false;
+            {
+                const juce::ScopedLock sl(lock);
+                for (auto* u : clients)
+                    busy = u->service() || busy;
+            }
+            waitMs = busy ? 1 : juce::jmin(maxIdleWaitMs, waitMs * 2);
+            wait(waitMs);
+        }
+    }
+
+    // Verrou partagé entre thread de message et thread de conception uniquement
+    juce::CriticalSection lock;
+    juce::Array<CoefficientUpdater*> clients;
+};
+
+CoefficientUpdater::CoefficientUpdater(juce::AudioProcessorValueTreeState& state)
+    : apvts(state)
+{
+    for (auto* id : designParameterIDs) {
+        apvts.addParameterListener(id, this);
+        parameterChanged(id, apvts.getRawParameterValue(id)->load());
+    }
+    designThread->add(this);
+}
+
+CoefficientUpdater::~CoefficientUpdater()
+{
+    designThread->remove(this);
+    for (auto* id : designParameterIDs)
+        apvts.removeParameterListener(id, this);
+}
+
+int CoefficientUpdater::bandMaskFor(const juce::String& parameterID) noexcept
+{
+    if (parameterID == "LowGain") return 1 << EQBands::low;
+    if (parameterID == "MidGain" || parameterID == "MidQ") return 1 << EQBands::mid;
+    if (parameterID == "HighGain") return 1 << EQBands::high;
+    return 0;
+}
+
+void CoefficientUpdater::parameterChanged(const juce::String& parameterID, float newValue)
+{
+    // Peut être appelé depuis le thread audio (automation) : uniquement des atomiques
+    if (parameterID == "LowGain") lowGain.store(newValue);
+    else if (parameterID == "MidGain") midGain.store(newValue);
+    else if (parameterID == "HighGain") highGain.store(newValue);
+    else if (parameterID == "MidQ") midQ.store(newValue);
+
+    const int mask = bandMaskFor(parameterID);
+    if (bulkDepth.load() > 0) {
+        bulkDirty.fetch_or(mask);
+        return;
+    }
+    designerDirty.fetch_or(mask);
+    inlineDirty.fetch_or(mask);
+    wakeDesigner();
+}
+
+void CoefficientUpdater::endBulkUpdate() noexcept
+{
+    if (bulkDepth.fetch_sub(1) != 1)
+        return;
+
+    const int mask = bulkDirty.exchange(0);
+    designerDirty.fetch_or(mask);
+    inlineDirty.fetch_or(mask);
+    wakeDesigner();
+}
+
+void CoefficientUpdater::wakeDesigner() noexcept
+{
+    // notify() prend un verrou : jamais depuis le thread audio, qui compte sur le sondage
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        designThread->notify();
+}
+
+EQParameters CoefficientUpdater::getParameters() const noexcept
+{
+    return { lowGain.load(), midGain.load(), highGain.load(), midQ.load() };
+}
+
+void CoefficientUpdater::designBand(EQCoefficientSet& set, int band, double rate, const EQParameters& params) const noexcept
+{
+    if (precise.load()) {
+        set.preciseBands[(size_t) band] = EQDesign::makeBandPrecise(band, rate, params);
+        set.bands[(size_t) band] = EQDesign::toFloat(set.preciseBands[(size_t) band]);
+    } else {
+        set.bands[(size_t) band] = table->makeBand(band, rate, params);
+    }
+}
+
+void CoefficientUpdater::prepare(double newSampleRate, EQCoefficientSet& dest, bool doublePrecision)
+{
+    sampleRate.store(newSampleRate);
+    precise.store(doublePrecision);
+    table->prepare(newSampleRate);
+
+    const auto params = getParameters();
+    dest.sampleRate = newSampleRate;
+    for (int b = 0; b < EQBands::numBands; ++b)
+        designBand(dest, b, newSampleRate, params);
+
+    // Le thread de conception republiera tout pour la nouvelle fréquence (et la précision)
+    inlineDirty.store(0);
+    designerDirty.fetch_or(allBands);
+    wakeDesigner();
+}
+
+bool CoefficientUpdater::service() noexcept
+{
+    const int dirty = designerDirty.exchange(0);
+    if (dirty == 0)
+        return false;
+
+    // Génération lue avant les paramètres : un jeu ne peut pas se dire plus récent qu'eux
+    const int designedGeneration = generation.load();
+    const double rate = sampleRate.load();
+    const auto params = getParameters();
+
+    // Toutes les bandes si la fréquence a changé, sinon seulement celles touchées
+    const int mask = designed.sampleRate != rate ? allBands : dirty;
+    designed.sampleRate = rate;
+    for (int b = 0; b < EQBands::numBands; ++b)
+        if (mask & (1 << b))
+            designBand(designed, b, rate, params);
+
+    auto& out = handover.getWriteBuffer();
+    out.set = designed;
+    out.generation = designedGeneration;
+    handover.publish();
+    return true;
+}
+
+bool CoefficientUpdater::pullLatest(EQCoefficientSet& dest, int minGeneration) noexcept
+{
+    if (!handover.pull())
+        return false;
+
+    // Un jeu conçu pour une ancienne fréquence (avant prepareToPlay) ou pour des paramètres
+    // remplacés depuis par un preset est ignoré
+    const auto& latest = handover.getReadBuffer();
+    if (latest.set.sampleRate != dest.sampleRate || latest.generation < minGeneration)
+        return false;
+
+    dest = latest.set;
+    return true;
+}
+
+bool CoefficientUpdater::designPending(EQCoefficientSet& dest, int minGeneration) noexcept
+{
+    if (generation.load() < minGeneration)
+        return false;
+
+    const int dirty = inlineDirty.exchange(0);
+    if (dirty == 0)
+        return false;
+
+    const auto params = getParameters();
+    for (int b = 0; b < EQBands::numBands; ++b)
+        if (dirty & (1 << b))
+            designBand(dest, b, dest.sampleRate, params);
+    return true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <JuceHeader.h>
+#include "CoefficientTable.h"
+#include "TripleBuffer.h"
+
+// Conception des coefficients propre à chaque instance, hors du thread audio.
+// Les changements de paramètres arrivent par le listener APVTS (flags "dirty"),
+// un thread partagé par toutes les instances conçoit les coefficients et les
+// publie dans un triple buffer que le thread audio lit sans verrou ni allocation.
+// Les coefficients viennent de la table partagée (CoefficientTable) quand elle est prête.
+// En double précision seulement, chaque bande est conçue directement en double (preciseBands)
+// et la version float en est l'arrondi : une seule conception par bande modifiée.
+class CoefficientUpdater : private juce::AudioProcessorValueTreeState::Listener
+{
+public:
+    explicit CoefficientUpdater(juce::AudioProcessorValueTreeState& state);
+    ~CoefficientUpdater() override;
+
+    // Audio arrêté (prepareToPlay) : conception synchrone de toutes les bandes,
+    // et demande de la table de cette fréquence. doublePrecision : l'hôte traite en double
+    void prepare(double sampleRate, EQCoefficientSet& dest, bool doublePrecision = false);
+
+    // Thread audio : récupère le dernier jeu publié. true si dest a changé.
+    // Les jeux conçus pour une génération de paramètres antérieure à minGeneration sont ignorés.
+    bool pullLatest(EQCoefficientSet& dest, int minGeneration = 0) noexcept;
+
+    // Thread audio en rendu offline : conçoit tout de suite les bandes modifiées
+    // (borné, sans allocation) pour rester synchrone avec l'automation.
+    // Rien n'est consommé tant que les paramètres n'ont pas atteint minGeneration.
+    bool designPending(EQCoefficientSet& dest, int minGeneration = 0) noexcept;
+
+    // Génération des paramètres : le processeur la fait avancer une fois les valeurs d'un preset
+    // appliquées ; chaque jeu publié porte la génération des paramètres dont il est issu
+    void setGeneration(int newGeneration) noexcept { generation.store(newGeneration); }
+
+    EQParameters getParameters() const noexcept;
+
+    // Restauration d'état : les changements de paramètres sont regroupés et
+    // les bandes touchées ne sont conçues qu'une fois, à la sortie du scope
+    struct ScopedBulkUpdate
+    {
+        explicit ScopedBulkUpdate(CoefficientUpdater& u) noexcept : updater(u) { updater.bulkDepth.fetch_add(1); }
+        ~ScopedBulkUpdate() noexcept { updater.endBulkUpdate(); }
+
+        CoefficientUpdater& updater;
+        JUCE_DECLARE_NON_COPYABLE(ScopedBulkUpdate)
+    };
+
+    // Appelé par le thread de conception partagé ; true si un jeu a été publié
+    bool service() noexcept;
+
+private:
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    static int bandMaskFor(const juce::String& parameterID) noexcept;
+    void designBand(EQCoefficientSet& set, int band, double rate, const EQParameters& params) const noexcept;
+    void endBulkUpdate() noexcept;
+    void wakeDesigner() noexcept;
+
+    juce::AudioProcessorValueTreeState& apvts;
+
+    std::atomic<float> lowGain { 0.0f }, midGain { 0.0f }, highGain { 0.0f }, midQ { 1.0f };
+    std::atomic<double> sampleRate { 44100.0 };
+    std::atomic<bool> precise { false };
+
+    // Un bit par bande ; deux masques pour que le thread de conception et le
+    // thread audio (mode offline) consomment les changements indépendamment
+    std::atomic<int> designerDirty { 0 }, inlineDirty { 0 };
+    // Pendant une restauration, les bandes modifiées s'accumulent ici
+    std::atomic<int> bulkDepth { 0 }, bulkDirty { 0 };
+
+    std::atomic<int> generation { 0 };
+
+    struct Published
+    {
+        EQCoefficientSet set;
+        int generation = 0;
+    };
+
+    EQCoefficientSet designed;   // utilisé uniquement par le thread de conception
+    TripleBuffer<Published> handover;
+
+    juce::SharedResourcePointer<CoefficientTable> table;
+
+    struct DesignThread;
+    juce::SharedResourcePointer<DesignThread> designThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CoefficientUpdater)
+};
@@ -0,0 +1,160 @@
+#include "DSPProfiler.h"
+
+const char* DSPProfiler::getStageName(Stage stage) noexcept
+{
+    switch (stage) {
+        case parameters:    return "parameters";
+        case updateFilters: return "updateFilters";
+        case lowBand:       return "low";
+        case midBand:       return "mid";
+        case highBand:      return "high";
+        case eqPass:        return "eq";
+        case saturation:    return "saturation";
+        case numStages:
+        default: break;
+    }
+    return "";
+}
+
+DSPProfiler::DSPProfiler()
+    : ticksPerMicro((double) juce::Time::getHighResolutionTicksPerSecond() * 1.0e-6)
+{
+}
+
+void DSPProfiler::addViewer() noexcept
+{
+    numViewers.fetch_add(1);
+}
+
+void DSPProfiler::removeViewer() noexcept
+{
+    jassert(numViewers.load() > 0);
+    numViewers.fetch_sub(1);
+}
+
+bool DSPProfiler::pullSnapshot(Snapshot& dest) noexcept
+{
+    const bool fresh = snapshots.pull();
+    if (fresh)
+        latest = snapshots.getReadBuffer();
+    dest = latest;
+    return fresh;
+}
+
+void DSPProfiler::resetTotals() noexcept
+{
+    stageTicks.fill(0);
+    blockTicks = maxBlockTicks = blocks = 0;
+    coefficientUpdatesAtReset = coefficientUpdates;
+    budgetMicros = maxBudgetPercent = 0.0;
+}
+
+void DSPProfiler::beginBlock(int numSamples, double sampleRate) noexcept
+{
+    // Mesure (re)partie de zéro à chaque ouverture d'affichage
+    const bool active = isActive();
+    if (active && !wasActive)
+        resetTotals();
+    wasActive = measuring = active;
+    if (!measuring)
+        return;
+
+    blockBudgetMicros = sampleRate > 0.0 ? numSamples * 1.0e6 / sampleRate : 0.0;
+    blockStart = juce::Time::getHighResolutionTicks();
+}
+
+void DSPProfiler::endBlock() noexcept
+{
+    if (!measuring)
+        return;
+    measuring = false;
+
+    const auto elapsed = juce::Time::getHighResolutionTicks() - blockStart;
+    blockTicks += elapsed;
+    maxBlockTicks = juce::jmax(maxBlockTicks, elapsed);
+    budgetMicros += blockBudgetMicros;
+    ++blocks;
+    if (blockBudgetMicros > 0.0)
+        maxBudgetPercent = juce::jmax(maxBudgetPercent, 100.0 * elapsed / ticksPerMicro / blockBudgetMicros);
+
+    auto& s = snapshots.getWriteBuffer();
+    const double perBlock = 1.0 / ((double) blocks * ticksPerMicro);
+    for (size_t i = 0; i < stageTicks.size(); ++i)
+        s.stageMicros[i] = (double) stageTicks[i] * perBlock;
+    s.blocksProcessed = blocks;
+    s.coefficientUpdates = coefficientUpdates - coefficientUpdatesAtReset;
+    s.meanBlockMicros = (double) blockTicks * perBlock;
+    s.maxBlockMicros = (double) maxBlockTicks / ticksPerMicro;
+    s.budgetPercent = budgetMicros > 0.0 ? 100.0 * (double) blockTicks / ticksPerMicro / budgetMicros : 0.0;
+    s.maxBudgetPercent = maxBudgetPercent;
+    snapshots.publish();
+}
+
+//==============================================================================
+ProfileDumper::ProfileDumper(DSPProfiler& p, const juce::File& f, int intervalMs)
+    : profiler(p), file(f), json(f.hasFileExtension("json") || f.hasFileExtension("jsonl"))
+{
+    profiler.addViewer();
+
+    if (!json && !file.existsAsFile()) {
+        juce::String header("time,blocks,coefficientUpdates,meanBlockUs,maxBlockUs,budgetPercent,maxBudgetPercent");
+        for (int i = 0; i < DSPProfiler::numStages; ++i)
+            header << "," << DSPProfiler::getStageName((DSPProfiler::Stage) i) << "Us";
+        file.appendText(header + "\n", false, false, "\n");
+    }
+    startTimer(juce::jmax(100, intervalMs));
+}
+
+ProfileDumper::~ProfileDumper()
+{
+    stopTimer();
+    profiler.removeViewer();
+}
+
+std::unique_ptr<ProfileDumper> ProfileDumper::createFromCommandLine(DSPProfiler& profiler)
+{
+    if (!juce::JUCEApplicationBase::isStandaloneApp())
+        return nullptr;
+
+    const auto args = juce::JUCEApplicationBase::getCommandLineParameterArray();
+    const int fileIndex = args.indexOf("--profile-dump");
+    if (fileIndex < 0 || args[fileIndex + 1].isEmpty())
+        return nullptr;
+
+    const auto file = juce::File::getCurrentWorkingDirectory().getChildFile(args[fileIndex + 1].unquoted());
+    const int intervalIndex = args.indexOf("--profile-interval");
+    const double seconds = intervalIndex >= 0 ? args[intervalIndex + 1].getDoubleValue() : 1.0;
+    return std::make_unique<ProfileDumper>(profiler, file, juce::roundToInt(seconds * 1000.0));
+}
+
+void ProfileDumper::timerCallback()
+{
+    // Rien de nouveau (audio arrêté) : pas de ligne
+    if (!profiler.pullSnapshot(snapshot))
+        return;
+
+    const auto time = juce::Time::getCurrentTime().toISO8601(true);
+    juce::String line;
+    if (json) {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("time", time);
+        object->setProperty("blocks", snapshot.blocksProcessed);
+        object->setProperty("coefficientUpdates", snapshot.coefficientUpdates);
+        object->setProperty("meanBlockUs", snapshot.meanBlockMicros);
+        object->setProperty("maxBlockUs", snapshot.maxBlockMicros);
+        object->setProperty("budgetPercent", snapshot.budgetPercent);
+        object->setProperty("maxBudgetPercent", snapshot.maxBudgetPercent);
+        auto* stages = new juce::DynamicObject();
+        for (int i = 0; i < DSPProfiler::numStages; ++i)
+            stages->setProperty(DSPProfiler::getStageName((DSPProfiler::Stage) i), snapshot.stageMicros[(size_t) i]);
+        object->setProperty("stagesUs", juce::var(stages));
+        line = juce::JSON::toString(juce::var(object), true);
+    } else {
+        line << time << ',' << snapshot.blocksProcessed << ',' << snapshot.coefficientUpdates << ','
+             << snapshot.meanBlockMicros << ',' << snapshot.maxBlockMicros << ','
+             << snapshot.budgetPercent << ',' << snapshot.maxBudgetPercent;
+        for (auto micros : snapshot.stageMicros)
+            line << ',' << micros;
+    }
+    file.appendText(line + "\n", false, false, "\n");
+}
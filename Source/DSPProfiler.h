@@ -0,0 +1,122 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "TripleBuffer.h"
+
+// Mesures de coût DSP propres à chaque instance.
+// Thread audio : chronos par étape et compteurs en variables locales, un instantané
+// publié par bloc dans un triple buffer (sans verrou ni allocation). Sans affichage
+// ni export ouvert, chaque point de mesure se réduit à un test d'atomique.
+// Les bandes ne sont chronométrées séparément qu'avec les filtres JUCE d'origine
+// (une passe par bande) ; les autres moteurs traitent les trois bandes dans une seule
+// boucle, comptée en eqPass.
+class DSPProfiler
+{
+public:
+    enum Stage
+    {
+        parameters = 0,     // lecture des paramètres, choix du moteur, latence
+        updateFilters,      // récupération / conception des coefficients
+        lowBand,
+        midBand,
+        highBand,
+        eqPass,             // trois bandes en une passe (cascade, SVF, dynamique, phase linéaire)
+        saturation,
+        numStages
+    };
+
+    static const char* getStageName(Stage stage) noexcept;
+
+    // Moyennes par bloc depuis l'ouverture du premier affichage
+    struct Snapshot
+    {
+        std::array<double, numStages> stageMicros {};
+        juce::int64 blocksProcessed = 0;
+        juce::int64 coefficientUpdates = 0;
+        double meanBlockMicros = 0.0, maxBlockMicros = 0.0;
+        double budgetPercent = 0.0;         // temps de calcul / durée audio traitée
+        double maxBudgetPercent = 0.0;      // pire bloc
+    };
+
+    DSPProfiler();
+
+    // Thread de message : affichages ou exports ouverts (activent la mesure)
+    void addViewer() noexcept;
+    void removeViewer() noexcept;
+    bool isActive() const noexcept { return numViewers.load(std::memory_order_relaxed) > 0; }
+
+    // Thread de message : copie le dernier instantané publié (true si un nouveau est arrivé).
+    // Plusieurs lecteurs possibles, tous sur le thread de message.
+    bool pullSnapshot(Snapshot& dest) noexcept;
+
+    // === Thread audio ===
+    // Rien n'est mesuré entre beginBlock et endBlock si personne ne regarde
+    void beginBlock(int numSamples, double sampleRate) noexcept;
+    void endBlock() noexcept;
+
+    // 0 hors mesure : stop() ne fait alors rien
+    juce::int64 start() const noexcept { return measuring ? juce::Time::getHighResolutionTicks() : 0; }
+    void stop(Stage stage, juce::int64 startTicks) noexcept
+    {
+        if (startTicks != 0)
+            stageTicks[(size_t) stage] += juce::Time::getHighResolutionTicks() - startTicks;
+    }
+
+    void countCoefficientUpdate() noexcept { ++coefficientUpdates; }
+
+    // Mesure d'un bloc entier (y compris les retours anticipés)
+    struct ScopedBlock
+    {
+        ScopedBlock(DSPProfiler& p, int numSamples, double sampleRate) noexcept : profiler(p)
+        {
+            profiler.beginBlock(numSamples, sampleRate);
+        }
+        ~ScopedBlock() noexcept { profiler.endBlock(); }
+
+        DSPProfiler& profiler;
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+private:
+    void resetTotals() noexcept;
+
+    std::atomic<int> numViewers { 0 };
+    const double ticksPerMicro;
+
+    // === Thread audio uniquement ===
+    bool measuring = false, wasActive = false;
+    juce::int64 blockStart = 0;
+    double blockBudgetMicros = 0.0;
+    std::array<juce::int64, numStages> stageTicks {};
+    juce::int64 blockTicks = 0, maxBlockTicks = 0, blocks = 0;
+    juce::int64 coefficientUpdates = 0, coefficientUpdatesAtReset = 0;
+    double budgetMicros = 0.0, maxBudgetPercent = 0.0;
+
+    TripleBuffer<Snapshot> snapshots;
+    Snapshot latest;     // thread de message
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DSPProfiler)
+};
+
+// Export périodique des instantanés (application standalone) : une ligne par période,
+// CSV (en-tête à la création) ou JSON Lines selon l'extension du fichier.
+// Garde le profiler actif tant qu'il existe.
+class ProfileDumper : private juce::Timer
+{
+public:
+    ProfileDumper(DSPProfiler& profiler, const juce::File& file, int intervalMs);
+    ~ProfileDumper() override;
+
+    // Standalone lancé avec --profile-dump <fichier> [--profile-interval <s>] : nullptr sinon
+    static std::unique_ptr<ProfileDumper> createFromCommandLine(DSPProfiler& profiler);
+
+private:
+    void timerCallback() override;
+
+    DSPProfiler& profiler;
+    juce::File file;
+    bool json = false;
+    DSPProfiler::Snapshot snapshot;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfileDumper)
+};
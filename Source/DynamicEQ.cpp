@@ -0,0 +1,302 @@
+#include "DynamicEQ.h"
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    constexpr double smoothingSeconds = 0.02;
+    // Variation de gain en deçà de laquelle une lane garde ses coefficients (~0.01 dB)
+    constexpr float amountTolerance = 1.0e-3f;
+    // ln(10) / 20 : dB -> logarithme népérien de l'amplitude
+    constexpr float decibelsToLog = 0.115129255f;
+
+    // Coefficient d'un suiveur d'enveloppe à un pôle : 63 % du chemin en timeMs
+    double followerCoefficient(float timeMs, double sampleRate) noexcept
+    {
+        return 1.0 - std::exp(-1.0 / (std::max(0.01, (double) timeMs) * 0.001 * sampleRate));
+    }
+}
+
+template <typename SampleType>
+DynamicEQ<SampleType>::DynamicEQ()
+{
+    midQ.setCurrentAndTargetValue(1.0f);
+    groups.resize(1);
+    prepare(sampleRate, 1);
+}
+
+template <typename SampleType>
+void DynamicEQ<SampleType>::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+    numPreparedChannels = std::max(1, numChannels);
+    groups.resize((size_t) ((numPreparedChannels + groupSize - 1) / groupSize));
+    for (int b = 0; b < EQBands::numBands; ++b)
+        prewarped[(size_t) b] = EQDesign::prewarp(b, sampleRate);
+    attack = (SampleType) followerCoefficient(settings.attackMs, sampleRate);
+    release = (SampleType) followerCoefficient(settings.releaseMs, sampleRate);
+
+    lowGain.reset(sampleRate, smoothingSeconds);
+    midGain.reset(sampleRate, smoothingSeconds);
+    highGain.reset(sampleRate, smoothingSeconds);
+    midQ.reset(sampleRate, smoothingSeconds);
+    reset();
+    snapToTargets();
+}
+
+template <typename SampleType>
+void DynamicEQ<SampleType>::reset()
+{
+    const auto zero = Vec::expand((SampleType) 0);
+    for (auto& g : groups)
+        for (auto& s : g) {
+            s.ic1eq = zero;
+            s.ic2eq = zero;
+            s.envelope = zero;
+        }
+}
+
+template <typename SampleType>
+void DynamicEQ<SampleType>::setParameters(const EQParameters& p, const DynamicEQSettings& newSettings)
+{
+    if (p.lowGain != lowGain.getTargetValue())   { lowGain.setTargetValue(p.lowGain); needsDesign = true; }
+    if (p.midGain != midGain.getTargetValue())   { midGain.setTargetValue(p.midGain); needsDesign = true; }
+    if (p.highGain != highGain.getTargetValue()) { highGain.setTargetValue(p.highGain); needsDesign = true; }
+    if (p.midQ != midQ.getTargetValue())         { midQ.setTargetValue(p.midQ); needsDesign = true; }
+
+    // Les seuils sont relus à chaque évaluation ; seuls les changements de mode forcent une conception
+    if (newSettings.enabled != settings.enabled)
+        needsDesign = true;
+    if (newSettings.attackMs != settings.attackMs)
+        attack = (SampleType) followerCoefficient(newSettings.attackMs, sampleRate);
+    if (newSettings.releaseMs != settings.releaseMs)
+        release = (SampleType) followerCoefficient(newSettings.releaseMs, sampleRate);
+    settings = newSettings;
+}
+
+template <typename SampleType>
+bool DynamicEQ<SampleType>::isNeutral() const noexcept
+{
+    return lowGain.getTargetValue() == 0.0f && midGain.getTargetValue() == 0.0f && highGain.getTargetValue() == 0.0f
+        && !lowGain.isSmoothing() && !midGain.isSmoothing() && !highGain.isSmoothing() && !needsDesign;
+}
+
+template <typename SampleType>
+typename DynamicEQ<SampleType>::Coeffs DynamicEQ<SampleType>::broadcast(const SVFCoefficients& d) noexcept
+{
+    return { Vec::expand((SampleType) d.a1), Vec::expand((SampleType) d.a2), Vec::expand((SampleType) (d.a2 / d.a1)),
+             Vec::expand((SampleType) d.m0), Vec::expand((SampleType) d.m1), Vec::expand((SampleType) d.m2),
+             Vec::expand((SampleType) d.k) };
+}
+
+template <typename SampleType>
+void DynamicEQ<SampleType>::designLane(Coeffs& c, int lane, int band, float amplitude, float q) const noexcept
+{
+    const auto d = EQDesign::makeStateVariableForAmplitude(band, prewarped[(size_t) band], amplitude, q);
+    const auto i = (size_t) lane;
+    c.a1.set(i, (SampleType) d.a1);
+    c.a2.set(i, (SampleType) d.a2);
+    c.g.set(i, (SampleType) (d.a2 / d.a1));
+    c.m0.set(i, (SampleType) d.m0);
+    c.m1.set(i, (SampleType) d.m1);
+    c.m2.set(i, (SampleType) d.m2);
+    c.k.set(i, (SampleType) d.k);
+}
+
+template <typename SampleType>
+void DynamicEQ<SampleType>::snapToTargets() noexcept
+{
+    lowGain.setCurrentAndTargetValue(lowGain.getTargetValue());
+    midGain.setCurrentAndTargetValue(midGain.getTargetValue());
+    highGain.setCurrentAndTargetValue(highGain.getTargetValue());
+    midQ.setCurrentAndTargetValue(midQ.getTargetValue());
+
+    // Enveloppes à zéro : les bandes dynamiques démarrent sans gain
+    const float gains[] = { lowGain.getTargetValue(), midGain.getTargetValue(), highGain.getTargetValue() };
+    const auto zero = Vec::expand((SampleType) 0);
+    for (int b = 0; b < EQBands::numBands; ++b) {
+        const float gain = settings.enabled[(size_t) b] ? 0.0f : gains[b];
+        const auto c = broadcast(EQDesign::makeStateVariable(b, prewarped[(size_t) b], gain,
+                                                             b == EQBands::mid ? midQ.getTargetValue() : EQBands::shelfQ));
+        for (auto& group : groups) {
+            auto& s = group[(size_t) b];
+            s.amount = zero;
+            s.current = s.target = c;
+            s.delta = { zero, zero, zero, zero, zero, zero, zero };
+        }
+    }
+    samplesUntilUpdate = 0;
+    needsDesign = false;
+}
+
+template <typename SampleType>
+void DynamicEQ<SampleType>::updateControl() noexcept
+{
+    const bool redesign = needsDesign || lowGain.isSmoothing() || midGain.isSmoothing() || highGain.isSmoothing() || midQ.isSmoothing();
+    needsDesign = false;
+
+    const float gains[] = { lowGain.skip(controlInterval), midGain.skip(controlInterval), highGain.skip(controlInterval) };
+    const float q = midQ.skip(controlInterval);
+    const auto zero = Vec::expand((SampleType) 0);
+    const auto step = Vec::expand((SampleType) 1 / (SampleType) controlInterval);
+
+    // Bandes statiques : même gain sur tous les canaux, une seule conception
+    std::array<bool, EQBands::numBands> dynamic {};
+    std::array<Coeffs, EQBands::numBands> staticTargets {};
+    for (int b = 0; b < EQBands::numBands; ++b) {
+        dynamic[(size_t) b] = settings.enabled[(size_t) b] && gains[b] != 0.0f;
+        if (redesign && !dynamic[(size_t) b])
+            staticTargets[(size_t) b] = broadcast(EQDesign::makeStateVariable(b, prewarped[(size_t) b], gains[b],
+                                                                              b == EQBands::mid ? q : EQBands::shelfQ));
+    }
+
+    for (size_t g = 0; g < groups.size(); ++g) {
+        // Les lanes au-delà des canaux préparés ne portent que du silence : pas de conception
+        const int numLanes = std::min(groupSize, numPreparedChannels - (int) g * groupSize);
+
+        for (int b = 0; b < EQBands::numBands; ++b) {
+            auto& s = groups[g][(size_t) b];
+
+            // On repart exactement de la cible précédente (pas de dérive d'interpolation)
+            s.current = s.target;
+            s.delta = { zero, zero, zero, zero, zero, zero, zero };
+
+            if (!dynamic[(size_t) b]) {
+                if (!redesign)
+                    continue;
+                s.target = staticTargets[(size_t) b];
+            } else {
+                // Sans passer par les dB : amount = ln(enveloppe / seuil) / ln(plage), A = exp(ln(A max) x amount)
+                const float logThreshold = settings.thresholdDb[(size_t) b] * decibelsToLog;
+                const float logGain = gains[b] * decibelsToLog * 0.5f;
+                bool changed = false;
+                for (int lane = 0; lane < numLanes; ++lane) {
+                    const float level = (float) s.envelope.get((size_t) lane);
+                    const float amount = level > 0.0f ? std::clamp((std::log(level) - logThreshold) / (rangeDb * decibelsToLog), 0.0f, 1.0f)
+                                                      : 0.0f;
+                    if (!redesign && std::abs(amount - (float) s.amount.get((size_t) lane)) < amountTolerance)
+                        continue;
+                    s.amount.set((size_t) lane, (SampleType) amount);
+                    designLane(s.target, lane, b, std::exp(logGain * amount), b == EQBands::mid ? q : EQBands::shelfQ);
+                    changed = true;
+                }
+                if (!changed)
+                    continue;
+            }
+
+            s.delta.a1 = (s.target.a1 - s.current.a1) * step;
+            s.delta.a2 = (s.target.a2 - s.current.a2) * step;
+            s.delta.g = (s.target.g - s.current.g) * step;
+            s.delta.m0 = (s.target.m0 - s.current.m0) * step;
+            s.delta.m1 = (s.target.m1 - s.current.m1) * step;
+            s.delta.m2 = (s.target.m2 - s.current.m2) * step;
+            s.delta.k = (s.target.k - s.current.k) * step;
+        }
+    }
+}
+
+template <typename SampleType>
+void DynamicEQ<SampleType>::process(SampleType* const* channels, int numChannels, int numSamples)
+{
+    assert(numChannels <= (int) groups.size() * groupSize);
+    numChannels = std::min(numChannels, (int) groups.size() * groupSize);
+
+    int pos = 0;
+    while (pos < numSamples) {
+        if (samplesUntilUpdate == 0) {
+            updateControl();
+            samplesUntilUpdate = controlInterval;
+        }
+        const int n = std::min(samplesUntilUpdate, numSamples - pos);
+        for (int first = 0, g = 0; first < numChannels; first += groupSize, ++g)
+            processGroup(groups[(size_t) g], channels + first, std::min(groupSize, numChannels - first), pos, n);
+        pos += n;
+        samplesUntilUpdate -= n;
+    }
+}
+
+template <typename SampleType>
+template <int band>
+typename DynamicEQ<SampleType>::Vec DynamicEQ<SampleType>::processSample(BandState& s, const Coeffs& c, Vec x,
+                                                                         bool detect, Vec attack, Vec release) noexcept
+{
+    const auto two = Vec::expand((SampleType) 2);
+    const auto zero = Vec::expand((SampleType) 0);
+
+    const auto v3 = x - s.ic2eq;
+    const auto v1 = c.a1 * s.ic1eq + c.a2 * v3;
+    const auto v2 = s.ic2eq + c.g * v1;
+    s.ic1eq = two * v1 - s.ic1eq;
+    s.ic2eq = two * v2 - s.ic2eq;
+
+    if (detect) {
+        // Sidechain = la bande vue par le SVF : passe-bas, passe-bande (gain 1 au centre), passe-haut
+        const auto side = band == EQBands::low ? v2
+                        : band == EQBands::mid ? c.k * v1
+                                               : x - c.k * v1 - v2;
+        // Crête, attaque/relâchement sans branchement : seule la partie du bon signe compte
+        const auto diff = Vec::max(side, zero - side) - s.envelope;
+        s.envelope = s.envelope + attack * Vec::max(diff, zero) + release * Vec::min(diff, zero);
+    }
+
+    // m0 = 1 hors high shelf, m2 = 0 pour le peak
+    if constexpr (band == EQBands::low)
+        return x + c.m1 * v1 + c.m2 * v2;
+    else if constexpr (band == EQBands::mid)
+        return x + c.m1 * v1;
+    else
+        return c.m0 * x + c.m1 * v1 + c.m2 * v2;
+}
+
+template <typename SampleType>
+void DynamicEQ<SampleType>::processGroup(GroupState& state, SampleType* const* channels,
+                                         int numChannels, int start, int numSamples) const noexcept
+{
+    assert(numSamples <= controlInterval);
+    auto st = state;
+    const std::array<bool, EQBands::numBands> detect = settings.enabled;
+    const auto attackCoeff = Vec::expand(attack);
+    const auto releaseCoeff = Vec::expand(release);
+
+    // Segment entrelacé d'avance : une trame écrite canal par canal puis relue en vecteur
+    // bloque le chargement (pas de store forwarding) et sérialiserait les échantillons
+    alignas(16 * sizeof(float)) SampleType frames[controlInterval][Vec::SIMDNumElements] = {};
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            frames[i][ch] = channels[ch][start + i];
+
+    for (int stepStart = 0; stepStart < numSamples; stepStart += rampStep) {
+        const int stepEnd = std::min(stepStart + rampStep, numSamples);
+
+        // Coefficients fixes sur le pas : restent en registres, rien à réécrire par échantillon
+        const auto low = st[EQBands::low].current;
+        const auto mid = st[EQBands::mid].current;
+        const auto high = st[EQBands::high].current;
+
+        for (int i = stepStart; i < stepEnd; ++i) {
+            auto x = Vec::fromRawArray(frames[i]);
+            x = processSample<EQBands::low>(st[EQBands::low], low, x, detect[EQBands::low], attackCoeff, releaseCoeff);
+            x = processSample<EQBands::mid>(st[EQBands::mid], mid, x, detect[EQBands::mid], attackCoeff, releaseCoeff);
+            x = processSample<EQBands::high>(st[EQBands::high], high, x, detect[EQBands::high], attackCoeff, releaseCoeff);
+            x.copyToRawArray(frames[i]);
+        }
+
+        const auto n = Vec::expand((SampleType) (stepEnd - stepStart));
+        for (auto& s : st) {
+            auto& c = s.current;
+            const auto& d = s.delta;
+            c.a1 = c.a1 + d.a1 * n; c.a2 = c.a2 + d.a2 * n; c.g = c.g + d.g * n;
+            c.m0 = c.m0 + d.m0 * n; c.m1 = c.m1 + d.m1 * n; c.m2 = c.m2 + d.m2 * n;
+            c.k = c.k + d.k * n;
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            channels[ch][start + i] = frames[i][ch];
+
+    state = st;
+}
+
+template class DynamicEQ<float>;
+template class DynamicEQ<double>;
@@ -0,0 +1,83 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "EQCoefficients.h"
+#include "SmoothedParameter.h"
+
+// Réglages du mode dynamique (seuils en dB FS, temps en ms)
+struct DynamicEQSettings
+{
+    std::array<bool, EQBands::numBands> enabled {};
+    std::array<float, EQBands::numBands> thresholdDb { -30.0f, -30.0f, -30.0f };
+    float attackMs = 2.0f, releaseMs = 60.0f;
+};
+
+// Mode dynamique : les SVF TPT de StateVariableEQ, dont le gain de chaque bande
+// dynamique suit le niveau du signal dans cette bande (p. ex. le peak 4 kHz qui
+// n'agit que sur les syllabes dures).
+// Gain appliqué = gain de la bande x min(1, dépassement du seuil / rangeDb) : rien
+// sous le seuil, tout le gain rangeDb au-dessus.
+// Le détecteur ne filtre rien lui-même : il lit les sorties du SVF de sa bande
+// (passe-bas, passe-bande normalisé ou passe-haut), déjà calculées pour l'EQ.
+// Le gain est réévalué tous les controlInterval échantillons, canal par canal, et les
+// coefficients interpolés entre deux évaluations par pas de rampStep échantillons :
+// le SVF reste stable sous modulation.
+template <typename SampleType>
+class DynamicEQ
+{
+public:
+    using Vec = SIMDVector<SampleType>;
+    static constexpr int groupSize = (int) Vec::SIMDNumElements;
+    static constexpr int controlInterval = 32;
+    static constexpr int rampStep = 8;
+    static constexpr float rangeDb = 12.0f;
+
+    DynamicEQ();
+
+    // Alloue l'état pour numChannels canaux (hors thread audio)
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    // Nouvelles cibles (gains en dB) : le lissage se fait dans process()
+    void setParameters(const EQParameters& params, const DynamicEQSettings& settings);
+
+    // Gains à 0 dB et lissage terminé : dynamique ou pas, les bandes laissent passer le signal
+    bool isNeutral() const noexcept;
+
+    void process(SampleType* const* channels, int numChannels, int numSamples);
+
+private:
+    // Coefficients par lane : chaque canal a son propre gain.
+    // g remplace a3 = g a2 : v2 = ic2eq + g v1, deux opérations de moins par échantillon
+    struct Coeffs
+    {
+        Vec a1, a2, g, m0, m1, m2, k;
+    };
+
+    struct BandState
+    {
+        Vec ic1eq, ic2eq, envelope, amount;
+        Coeffs current, target, delta;
+    };
+
+    using GroupState = std::array<BandState, EQBands::numBands>;
+
+    static Coeffs broadcast(const SVFCoefficients& d) noexcept;
+    void designLane(Coeffs& c, int lane, int band, float amplitude, float q) const noexcept;
+    void updateControl() noexcept;
+    void snapToTargets() noexcept;
+    template <int band>
+    static Vec processSample(BandState& s, const Coeffs& c, Vec x, bool detect, Vec attack, Vec release) noexcept;
+    void processGroup(GroupState& state, SampleType* const* channels, int numChannels, int start, int numSamples) const noexcept;
+
+    std::vector<GroupState> groups;
+    std::array<double, EQBands::numBands> prewarped {};
+    DynamicEQSettings settings;
+    SmoothedParameter<> lowGain, midGain, highGain;
+    SmoothedParameter<SmoothingType::multiplicative> midQ;
+    SampleType attack = 1, release = 1;
+    double sampleRate = 44100.0;
+    int numPreparedChannels = 1;
+    int samplesUntilUpdate = 0;
+    bool needsDesign = true;
+};
@@ -0,0 +1,192 @@
+#include "EQCoefficients.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+    constexpr double pi = 3.141592653589793238;
+
+    PreciseBiquadCoefficients normalise(double b0, double b1, double b2, double a0, double a1, double a2) noexcept
+    {
+        const double inv = 1.0 / a0;
+        return { b0 * inv, b1 * inv, b2 * inv, a1 * inv, a2 * inv };
+    }
+
+    double omegaFor(double sampleRate, float frequency) noexcept
+    {
+        return 2.0 * pi * std::max(2.0, (double) frequency) / sampleRate;
+    }
+
+    PreciseBiquadCoefficients lowShelf(double sampleRate, float frequency, float q, float gainDb) noexcept
+    {
+        const double A = std::sqrt(std::max(0.0, (double) EQDesign::decibelsToGain(gainDb)));
+        const double aminus1 = A - 1.0, aplus1 = A + 1.0;
+        const double omega = omegaFor(sampleRate, frequency);
+        const double coso = std::cos(omega);
+        const double beta = std::sin(omega) * std::sqrt(A) / q;
+        const double aminus1TimesCoso = aminus1 * coso;
+
+        return normalise(A * (aplus1 - aminus1TimesCoso + beta),
+                         A * 2.0 * (aminus1 - aplus1 * coso),
+                         A * (aplus1 - aminus1TimesCoso - beta),
+                         aplus1 + aminus1TimesCoso + beta,
+                         -2.0 * (aminus1 + aplus1 * coso),
+                         aplus1 + aminus1TimesCoso - beta);
+    }
+
+    PreciseBiquadCoefficients peak(double sampleRate, float frequency, float q, float gainDb) noexcept
+    {
+        const double A = std::sqrt(std::max(0.0, (double) EQDesign::decibelsToGain(gainDb)));
+        const double omega = omegaFor(sampleRate, frequency);
+        const double alpha = std::sin(omega) / (q * 2.0);
+        const double c2 = -2.0 * std::cos(omega);
+        const double alphaTimesA = alpha * A;
+        const double alphaOverA = alpha / A;
+
+        return normalise(1.0 + alphaTimesA, c2, 1.0 - alphaTimesA,
+                         1.0 + alphaOverA, c2, 1.0 - alphaOverA);
+    }
+
+    PreciseBiquadCoefficients highShelf(double sampleRate, float frequency, float q, float gainDb) noexcept
+    {
+        const double A = std::sqrt(std::max(0.0, (double) EQDesign::decibelsToGain(gainDb)));
+        const double aminus1 = A - 1.0, aplus1 = A + 1.0;
+        const double omega = omegaFor(sampleRate, frequency);
+        const double coso = std::cos(omega);
+        const double beta = std::sin(omega) * std::sqrt(A) / q;
+        const double aminus1TimesCoso = aminus1 * coso;
+
+        return normalise(A * (aplus1 + aminus1TimesCoso + beta),
+                         A * -2.0 * (aminus1 + aplus1 * coso),
+                         A * (aplus1 + aminus1TimesCoso - beta),
+                         aplus1 - aminus1TimesCoso + beta,
+                         2.0 * (aminus1 - aplus1 * coso),
+                         aplus1 - aminus1TimesCoso - beta);
+    }
+}
+
+namespace EQDesign
+{
+    BiquadCoefficients toFloat(const PreciseBiquadCoefficients& c) noexcept
+    {
+        return { (float) c.b0, (float) c.b1, (float) c.b2, (float) c.a1, (float) c.a2 };
+    }
+
+    BiquadCoefficients makeLowShelf(double sampleRate, float frequency, float q, float gainDb) noexcept
+    {
+        return toFloat(lowShelf(sampleRate, frequency, q, gainDb));
+    }
+
+    BiquadCoefficients makePeak(double sampleRate, float frequency, float q, float gainDb) noexcept
+    {
+        return toFloat(peak(sampleRate, frequency, q, gainDb));
+    }
+
+    BiquadCoefficients makeHighShelf(double sampleRate, float frequency, float q, float gainDb) noexcept
+    {
+        return toFloat(highShelf(sampleRate, frequency, q, gainDb));
+    }
+
+    BiquadCoefficients makeBand(int band, double sampleRate, const EQParameters& p) noexcept
+    {
+        return toFloat(makeBandPrecise(band, sampleRate, p));
+    }
+
+    PreciseBiquadCoefficients makeBandPrecise(int band, double sampleRate, const EQParameters& p) noexcept
+    {
+        // A = 1 donne b = a : on renvoie directement le biquad neutre plutôt que des arrondis
+        const float gain = band == EQBands::low ? p.lowGain : band == EQBands::mid ? p.midGain : p.highGain;
+        if (gain == 0.0f)
+            return {};
+
+        switch (band) {
+            case EQBands::low:  return lowShelf(sampleRate, EQBands::lowFrequency, EQBands::shelfQ, p.lowGain);
+            case EQBands::mid:  return peak(sampleRate, EQBands::midFrequency, p.midQ, p.midGain);
+            case EQBands::high: return highShelf(sampleRate, EQBands::highFrequency, EQBands::shelfQ, p.highGain);
+            default: break;
+        }
+        assert(false);
+        return {};
+    }
+
+    double prewarp(int band, double sampleRate) noexcept
+    {
+        const float frequency = band == EQBands::low ? EQBands::lowFrequency
+                              : band == EQBands::mid ? EQBands::midFrequency
+                                                     : EQBands::highFrequency;
+
+        // Pré-distorsion bilinéaire, bornée sous Nyquist
+        return std::tan(pi * std::min((double) frequency, sampleRate * 0.49) / sampleRate);
+    }
+
+    SVFCoefficients makeStateVariable(int band, double prewarped, float gainDb, float q) noexcept
+    {
+        return makeStateVariableForAmplitude(band, prewarped, std::pow(10.0, gainDb / 40.0), q);
+    }
+
+    SVFCoefficients makeStateVariableForAmplitude(int band, double prewarped, double A, float q) noexcept
+    {
+        double g = prewarped;
+        double k = 1.0 / q;
+
+        SVFCoefficients c;
+        switch (band) {
+            case EQBands::low:
+                g /= std::sqrt(A);
+                c.m1 = k * (A - 1.0);
+                c.m2 = A * A - 1.0;
+                break;
+            case EQBands::mid:
+                k = 1.0 / (q * A);
+                c.m1 = k * (A * A - 1.0);
+                break;
+            default:
+                g *= std::sqrt(A);
+                c.m0 = A * A;
+                c.m1 = k * (1.0 - A) * A;
+                c.m2 = 1.0 - A * A;
+                break;
+        }
+
+        c.k = k;
+        c.a1 = 1.0 / (1.0 + g * (g + k));
+        c.a2 = g * c.a1;
+        c.a3 = g * c.a2;
+        return c;
+    }
+
+    int decaySamples(const BiquadCoefficients& c, double threshold) noexcept
+    {
+        // Rayon du pôle dominant de 1 + a1 z^-1 + a2 z^-2
+        const double a1 = c.a1, a2 = c.a2;
+        const double disc = a1 * a1 - 4.0 * a2;
+        const double radius = disc < 0.0 ? std::sqrt(a2) : 0.5 * (std::abs(a1) + std::sqrt(disc));
+
+        if (radius <= 0.0)
+            return 2;
+        if (radius >= 1.0) {
+            assert(false); // section instable
+            return std::numeric_limits<int>::max() / 4;
+        }
+        return 2 + (int) std::ceil(std::log(threshold) / std::log(radius));
+    }
+
+    int worstCaseTailSamples(double sampleRate, double threshold) noexcept
+    {
+        // Sections en série : les traînes s'additionnent
+        constexpr int steps = 24;
+        std::array<int, EQBands::numBands> worst {};
+        for (int i = 0; i <= steps; ++i) {
+            for (int j = 0; j <= steps; ++j) {
+                const float gain = EQBands::minGainDb + (EQBands::maxGainDb - EQBands::minGainDb) * ((float) i / steps);
+                const float q = EQBands::minQ + (EQBands::maxQ - EQBands::minQ) * ((float) j / steps);
+                const EQParameters p { gain, gain, gain, q };
+                for (int b = 0; b < EQBands::numBands; ++b)
+                    worst[(size_t) b] = std::max(worst[(size_t) b], decaySamples(makeBand(b, sampleRate, p), threshold));
+            }
+        }
+        return worst[0] + worst[1] + worst[2];
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include "BiquadCascade.h"
+
+// Réglages fixes des trois bandes de MerjEQ
+namespace EQBands
+{
+    enum Band { low = 0, mid = 1, high = 2, numBands = 3 };
+
+    constexpr float lowFrequency = 200.0f;
+    constexpr float midFrequency = 4000.0f;
+    constexpr float highFrequency = 12000.0f;
+    constexpr float shelfQ = 0.707f;
+
+    // Plages des paramètres du plugin
+    constexpr float minGainDb = -12.0f, maxGainDb = 12.0f;
+    constexpr float minQ = 0.1f, maxQ = 5.0f;
+}
+
+// Valeurs des paramètres utilisées pour concevoir les filtres (gains en dB)
+struct EQParameters
+{
+    float lowGain = 0.0f, midGain = 0.0f, highGain = 0.0f;
+    float midQ = 1.0f;
+};
+
+// Jeu complet de coefficients pour une fréquence d'échantillonnage donnée
+struct EQCoefficientSet
+{
+    double sampleRate = 0.0;
+    std::array<BiquadCoefficients, EQBands::numBands> bands {};
+    // Mêmes bandes sans arrondi float, pour le traitement en double précision ;
+    // conçues seulement quand l'hôte traite en double (sinon laissées telles quelles)
+    std::array<PreciseBiquadCoefficients, EQBands::numBands> preciseBands {};
+
+    // Toutes les bandes à 0 dB : la cascade ne modifie pas le signal
+    bool isIdentity() const noexcept
+    {
+        for (auto& c : bands)
+            if (c.b0 != 1.0f || c.b1 != 0.0f || c.b2 != 0.0f || c.a1 != 0.0f || c.a2 != 0.0f)
+                return false;
+        return true;
+    }
+};
+
+// SVF TPT (Simper) : a1..a3 pour la récursion, m0..m2 pour mélanger entrée,
+// passe-bande (v1) et passe-bas (v2) ; k est l'amortissement de la récursion
+struct SVFCoefficients
+{
+    double a1 = 1, a2 = 0, a3 = 0;
+    double m0 = 1, m1 = 0, m2 = 0;
+    double k = 1;
+};
+
+// Conception RBJ (mêmes formules que juce::dsp::IIR::Coefficients::makeXxx),
+// calculée en double, sans allocation : utilisable depuis n'importe quel thread.
+namespace EQDesign
+{
+    BiquadCoefficients makeLowShelf(double sampleRate, float frequency, float q, float gainDb) noexcept;
+    BiquadCoefficients makePeak(double sampleRate, float frequency, float q, float gainDb) noexcept;
+    BiquadCoefficients makeHighShelf(double sampleRate, float frequency, float q, float gainDb) noexcept;
+
+    // Arrondi float d'un biquad conçu en double (identique à makeBand pour les mêmes paramètres)
+    BiquadCoefficients toFloat(const PreciseBiquadCoefficients& c) noexcept;
+
+    // Conçoit la bande demandée à partir des paramètres courants (neutre exact à 0 dB)
+    BiquadCoefficients makeBand(int band, double sampleRate, const EQParameters& params) noexcept;
+    PreciseBiquadCoefficients makeBandPrecise(int band, double sampleRate, const EQParameters& params) noexcept;
+
+    // SVF de même amplitude que le biquad de la bande. prewarped = prewarp(band, sampleRate) :
+    // calculé une fois, il suffit ensuite d'un pow et d'une division par jeu de coefficients
+    double prewarp(int band, double sampleRate) noexcept;
+    SVFCoefficients makeStateVariable(int band, double prewarped, float gainDb, float q) noexcept;
+    // Même conception, gain déjà converti en amplitude A = 10^(gainDb / 40) : pas de pow
+    SVFCoefficients makeStateVariableForAmplitude(int band, double prewarped, double amplitude, float q) noexcept;
+
+    // Nombre d'échantillons pour que la réponse d'une section retombe sous threshold
+    // (pôle dominant ; entrée impulsionnelle d'amplitude 1)
+    int decaySamples(const BiquadCoefficients& c, double threshold) noexcept;
+
+    // Pire traîne des trois sections en série sur toute la plage des paramètres
+    // (les pôles du SVF sont ceux des biquads : vaut pour tous les moteurs IIR)
+    int worstCaseTailSamples(double sampleRate, double threshold) noexcept;
+
+    // Conversions dB <-> gain, mêmes formules et même plancher que juce::Decibels
+    inline float decibelsToGain(float db, float minusInfinityDb = -100.0f) noexcept
+    {
+        return db > minusInfinityDb ? std::pow(10.0f, db * 0.05f) : 0.0f;
+    }
+
+    inline float gainToDecibels(float gain, float minusInfinityDb = -100.0f) noexcept
+    {
+        return gain > 0.0f ? std::max(minusInfinityDb, std::log10(gain) * 20.0f) : minusInfinityDb;
+    }
+}
@@ -0,0 +1,65 @@
+#include "EQResponse.h"
+
+void EQResponse::setSampleRate(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    for (int i = 0; i < numPoints; ++i) {
+        const double w = juce::MathConstants<double>::twoPi * SpectrumAnalyzer::frequencyOfPoint(i) / sampleRate;
+        cos1[(size_t) i] = (float) std::cos(w);
+        sin1[(size_t) i] = (float) std::sin(w);
+        cos2[(size_t) i] = (float) std::cos(2.0 * w);
+        sin2[(size_t) i] = (float) std::sin(2.0 * w);
+    }
+}
+
+void EQResponse::update(int bandMask, const EQParameters& params)
+{
+    jassert(sampleRate > 0.0);
+    if (bandMask == 0)
+        return;
+
+    for (int b = 0; b < EQBands::numBands; ++b)
+        if (bandMask & (1 << b))
+            evaluate(table->makeBand(b, sampleRate, params), bandMagnitudeDb[(size_t) b], bandPhase[(size_t) b]);
+
+    // Sections en série : les dB et les phases s'additionnent
+    for (int i = 0; i < numPoints; ++i) {
+        float db = 0.0f, ph = 0.0f;
+        for (int b = 0; b < EQBands::numBands; ++b) {
+            db += bandMagnitudeDb[(size_t) b][(size_t) i];
+            ph += bandPhase[(size_t) b][(size_t) i];
+        }
+        magnitudeDb[(size_t) i] = db;
+        phase[(size_t) i] = std::remainder(ph, juce::MathConstants<float>::twoPi);
+    }
+}
+
+void EQResponse::evaluate(const BiquadCoefficients& c, Curve& bandMagnitude, Curve& bandPhaseOut) noexcept
+{
+    // H = N / D avec N = b0 + b1 z^-1 + b2 z^-2 et D = 1 + a1 z^-1 + a2 z^-2, z^-k = cos kw - j sin kw
+    const auto b0 = Vec::expand(c.b0), b1 = Vec::expand(c.b1), b2 = Vec::expand(c.b2);
+    const auto a1 = Vec::expand(c.a1), a2 = Vec::expand(c.a2);
+    const auto one = Vec::expand(1.0f);
+
+    for (int i = 0; i < numPoints; i += (int) Vec::SIMDNumElements) {
+        const auto c1 = Vec::fromRawArray(cos1.data() + i), s1 = Vec::fromRawArray(sin1.data() + i);
+        const auto c2 = Vec::fromRawArray(cos2.data() + i), s2 = Vec::fromRawArray(sin2.data() + i);
+
+        const auto nr = b0 + b1 * c1 + b2 * c2;
+        const auto ni = Vec::expand(0.0f) - (b1 * s1 + b2 * s2);
+        const auto dr = one + a1 * c1 + a2 * c2;
+        const auto di = Vec::expand(0.0f) - (a1 * s1 + a2 * s2);
+
+        // |N|², |D|² et N * conj(D), dont l'argument est celui de H
+        (nr * nr + ni * ni).copyToRawArray(numPower.data() + i);
+        (dr * dr + di * di).copyToRawArray(denPower.data() + i);
+        (nr * dr + ni * di).copyToRawArray(crossRe.data() + i);
+        (ni * dr - nr * di).copyToRawArray(crossIm.data() + i);
+    }
+
+    // log10 et atan2 n'existent pas en SIMDRegister : passe scalaire sur les résultats
+    for (size_t i = 0; i < (size_t) numPoints; ++i) {
+        bandMagnitude[i] = 10.0f * std::log10(juce::jmax(numPower[i], 1.0e-20f) / juce::jmax(denPower[i], 1.0e-20f));
+        bandPhaseOut[i] = std::atan2(crossIm[i], crossRe[i]);
+    }
+}
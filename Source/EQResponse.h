@@ -0,0 +1,44 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "CoefficientTable.h"
+#include "SpectrumAnalyzer.h"
+
+// Réponse en amplitude et en phase de la cascade low shelf / mid peak / high shelf,
+// aux mêmes points log que SpectrumAnalyzer. Coefficients identiques à ceux de
+// updateFilters() (table partagée), contribution de chaque bande gardée en cache :
+// un mouvement de knob ne réévalue que sa bande.
+// Évaluation de H(e^jw) en complexe, plusieurs points par registre SIMD.
+class EQResponse
+{
+public:
+    static constexpr int numPoints = SpectrumAnalyzer::numPoints;
+    using Curve = std::array<float, numPoints>;
+
+    // Recalcule les e^-jw des points ; toutes les bandes sont à réévaluer
+    void setSampleRate(double newSampleRate);
+    double getSampleRate() const noexcept { return sampleRate; }
+
+    // Réévalue les bandes de bandMask (un bit par bande) puis la somme
+    void update(int bandMask, const EQParameters& params);
+
+    const Curve& getMagnitudeDb() const noexcept { return magnitudeDb; }
+    const Curve& getPhase() const noexcept { return phase; }   // radians, repliée sur [-pi, pi]
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static_assert(numPoints % Vec::SIMDNumElements == 0, "numPoints doit être un multiple de la largeur SIMD");
+
+    void evaluate(const BiquadCoefficients& c, Curve& bandMagnitudeDb, Curve& bandPhase) noexcept;
+
+    double sampleRate = 0.0;
+
+    // z^-1 et z^-2 sur le cercle unité, un tableau par composante (lecture alignée)
+    alignas(32) Curve cos1 {}, sin1 {}, cos2 {}, sin2 {};
+    alignas(32) Curve numPower {}, denPower {}, crossRe {}, crossIm {};
+
+    std::array<Curve, EQBands::numBands> bandMagnitudeDb {}, bandPhase {};
+    Curve magnitudeDb {}, phase {};
+
+    juce::SharedResourcePointer<CoefficientTable> table;
+};
@@ -0,0 +1,103 @@
+#include "EditorResources.h"
+#include "BinaryData.h"
+
+struct EditorResources::DecodeThread : public juce::Thread
+{
+    explicit DecodeThread(EditorResources& r) : juce::Thread("MerjEQ asset decoder"), owner(r) { startThread(); }
+    ~DecodeThread() override { stopThread(5000); }
+
+    void run() override { owner.decodeImages(); }
+
+    EditorResources& owner;
+};
+
+EditorResources::EditorResources()
+{
+    decodeThread = std::make_unique<DecodeThread>(*this);
+}
+
+EditorResources::~EditorResources()
+{
+    decodeThread.reset();
+    cancelPendingUpdate();
+}
+
+void EditorResources::decodeImages()
+{
+    struct Source { const char* data; int size; };
+    const std::array<Source, numImages> sources { {
+        { BinaryData::backgroundmodern_png, BinaryData::backgroundmodern_pngSize },
+        { BinaryData::blackknob_png,        BinaryData::blackknob_pngSize },
+        { BinaryData::pinkknob_png,         BinaryData::pinkknob_pngSize },
+        { BinaryData::whiteknob_png,        BinaryData::whiteknob_pngSize },
+        { BinaryData::SaturationON_png,     BinaryData::SaturationON_pngSize },
+        { BinaryData::SaturationOFF_png,    BinaryData::SaturationOFF_pngSize },
+    } };
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    std::array<juce::Image, numImages> decoded;
+    juce::int64 bytes = 0;
+
+    for (size_t i = 0; i < sources.size(); ++i) {
+        if (juce::Thread::currentThreadShouldExit())
+            return;
+        decoded[i] = juce::ImageFileFormat::loadFrom(sources[i].data, (size_t) sources[i].size);
+        if (decoded[i].isValid())
+            bytes += (juce::int64) decoded[i].getWidth() * decoded[i].getHeight() * 4;
+    }
+
+    {
+        const juce::ScopedLock sl(lock);
+        images = decoded;
+        stats.decodeMilliseconds = juce::Time::getMillisecondCounterHiRes() - start;
+        stats.sharedImageBytes = bytes;
+    }
+    ready = true;
+    triggerAsyncUpdate();
+}
+
+void EditorResources::handleAsyncUpdate()
+{
+    sendChangeMessage();
+}
+
+juce::Image EditorResources::getImage(ImageID id) const
+{
+    const juce::ScopedLock sl(lock);
+    return images[(size_t) id];
+}
+
+juce::Typeface::Ptr EditorResources::getTitleTypeface()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    if (titleTypeface == nullptr)
+        titleTypeface = juce::Typeface::createSystemTypefaceFor(BinaryData::Metropolitan_ttf, BinaryData::Metropolitan_ttfSize);
+    return titleTypeface;
+}
+
+juce::Typeface::Ptr EditorResources::getValueTypeface()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    if (valueTypeface == nullptr)
+        valueTypeface = juce::Typeface::createSystemTypefaceFor(BinaryData::upheavtt_ttf, BinaryData::upheavtt_ttfSize);
+    return valueTypeface;
+}
+
+void EditorResources::editorOpened(double openMilliseconds)
+{
+    const juce::ScopedLock sl(lock);
+    stats.lastEditorOpenMilliseconds = openMilliseconds;
+    ++stats.numEditors;
+}
+
+void EditorResources::editorClosed()
+{
+    const juce::ScopedLock sl(lock);
+    --stats.numEditors;
+}
+
+EditorResources::Stats EditorResources::getStats() const
+{
+    const juce::ScopedLock sl(lock);
+    return stats;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+
+// Images et polices de l'éditeur, décodées une seule fois pour tout le process et
+// partagées par les éditeurs ouverts (juce::SharedResourcePointer) : tout est libéré
+// à la fermeture du dernier éditeur.
+// Les PNG sont décodés sur un thread de fond : tant qu'ils ne sont pas prêts,
+// getImage() renvoie une image invalide (l'éditeur dessine un fond uni) et les
+// éditeurs sont prévenus par ChangeBroadcaster quand tout est décodé.
+class EditorResources : public juce::ChangeBroadcaster,
+                        private juce::AsyncUpdater
+{
+public:
+    enum ImageID { background = 0, blackKnob, pinkKnob, whiteKnob, saturationOn, saturationOff, numImages };
+
+    // Mesures pour suivre le coût d'ouverture des éditeurs
+    struct Stats
+    {
+        double decodeMilliseconds = 0.0;        // décodage des PNG (thread de fond)
+        juce::int64 sharedImageBytes = 0;       // pixels partagés par tous les éditeurs
+        double lastEditorOpenMilliseconds = 0.0;
+        int numEditors = 0;
+    };
+
+    EditorResources();
+    ~EditorResources() override;
+
+    bool isReady() const noexcept { return ready.load(); }
+    juce::Image getImage(ImageID id) const;
+
+    // Créées au premier appel (thread de message), puis partagées
+    juce::Typeface::Ptr getTitleTypeface();    // Metropolitan
+    juce::Typeface::Ptr getValueTypeface();    // Upheaval
+
+    void editorOpened(double openMilliseconds);
+    void editorClosed();
+    Stats getStats() const;             // copie cohérente (le décodage écrit depuis son thread)
+
+private:
+    void decodeImages();
+    void handleAsyncUpdate() override;
+
+    struct DecodeThread;
+    std::unique_ptr<DecodeThread> decodeThread;
+
+    mutable juce::CriticalSection lock;
+    std::array<juce::Image, numImages> images;
+    std::atomic<bool> ready { false };
+    Stats stats;
+
+    juce::Typeface::Ptr titleTypeface, valueTypeface;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EditorResources)
+};
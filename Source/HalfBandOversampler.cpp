@@ -0,0 +1,336 @@
+#include "HalfBandOversampler.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace
+{
+    constexpr double pi = 3.141592653589793238;
+
+    // Gabarit des étages : le premier protège la bande audio (transition autour de fs/2,
+    // largeur relative au rythme suréchantillonné), les suivants n'ont que des images lointaines
+    constexpr double firstTransition = 0.045, laterTransition = 0.25;
+    constexpr int firstAllpassCoefficients = 12, laterAllpassCoefficients = 4;
+    constexpr double firAttenuationDb = 100.0;
+
+    // === Coefficients des passe-tout (méthode elliptique de HIIR, L. de Soras) ===
+    double ellipticSum(double q, int order, int c, bool numerator) noexcept
+    {
+        double acc = 0.0, term = 0.0;
+        int i = numerator ? 0 : 1;
+        double sign = numerator ? 1.0 : -1.0;
+        do {
+            term = numerator ? std::pow(q, (double) (i * (i + 1))) * std::sin((i * 2 + 1) * c * pi / order)
+                             : std::pow(q, (double) (i * i)) * std::cos(i * 2 * c * pi / order);
+            acc += sign * term;
+            sign = -sign;
+            ++i;
+        } while (std::abs(term) > 1e-100);
+        return acc;
+    }
+
+    double allpassCoefficient(int index, double k, double q, int order) noexcept
+    {
+        const int c = index + 1;
+        const double num = ellipticSum(q, order, c, true) * std::pow(q, 0.25);
+        const double den = ellipticSum(q, order, c, false) + 0.5;
+        const double ww = num / den;
+        const double wwsq = ww * ww;
+        const double x = std::sqrt((1.0 - wwsq * k) * (1.0 - wwsq / k)) / (1.0 + wwsq);
+        return (1.0 - x) / (1.0 + x);
+    }
+
+    // Bessel modifiée d'ordre 0 (fenêtre de Kaiser)
+    double besselI0(double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 64 && term > 1e-12 * sum; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::History::prepare(int size)
+{
+    length = std::max(1, size);
+    data.assign((size_t) (2 * length), Vec::expand((SampleType) 0));
+    pos = 0;
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::History::clear() noexcept
+{
+    std::fill(data.begin(), data.end(), Vec::expand((SampleType) 0));
+    pos = 0;
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::designAllpass(Stage& stage, int numCoefficients, double transition)
+{
+    const int order = numCoefficients * 2 + 1;
+    double k = std::tan((1.0 - transition * 2.0) * pi / 4.0);
+    k *= k;
+    const double kksqrt = std::pow(1.0 - k * k, 0.25);
+    const double e = 0.5 * (1.0 - kksqrt) / (1.0 + kksqrt);
+    const double e4 = e * e * e * e;
+    const double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));
+
+    // Coefficients alternés entre les deux branches ; retard au continu d'un passe-tout : (1 - a) / (1 + a)
+    std::array<double, 2> branchDelay { 0.0, 1.0 };
+    for (auto& branch : stage.allpass)
+        branch.clear();
+    for (int i = 0; i < numCoefficients; ++i) {
+        const double a = allpassCoefficient(i, k, q, order);
+        stage.allpass[(size_t) (i & 1)].push_back((SampleType) a);
+        branchDelay[(size_t) (i & 1)] += 2.0 * (1.0 - a) / (1.0 + a);
+    }
+    stage.delay = 0.5 * (branchDelay[0] + branchDelay[1]);
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::designFIR(Stage& stage, int numTaps, double transition, double attenuationDb)
+{
+    // Longueur de Kaiser arrondie à 4m + 3 : centre impair, coefficients pairs non nuls
+    if (numTaps <= 0)
+        numTaps = (int) std::ceil((attenuationDb - 8.0) / (2.285 * 2.0 * pi * transition)) + 1;
+    const int m = std::max(0, numTaps / 4);               // plus petit m tel que 4m + 3 >= numTaps
+    const int length = 4 * m + 3;
+    const int centre = 2 * m + 1;
+    const double beta = 0.1102 * (attenuationDb - 8.7);
+
+    stage.taps.clear();
+    for (int k = 0; k <= length - 1; k += 2) {
+        const double n = (double) (k - centre);            // impair : sinc(n/2) non nul
+        const double r = n / (double) centre;
+        const double window = besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / besselI0(beta);
+        stage.taps.push_back((SampleType) (std::sin(pi * n / 2.0) / (pi * n) * window));
+    }
+    stage.centre = centre;
+    stage.delay = (double) centre;
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::prepare(int numChannels, int numStages, FilterType type, int maxBlockSize)
+{
+    numChannels = std::max(1, numChannels);
+    numStages = std::clamp(numStages, 1, maxStages);
+    filterType = type;
+    blockSize = std::max(1, maxBlockSize);
+    const int factor = 1 << numStages;
+
+    stages.assign((size_t) numStages, {});
+    for (int s = 0; s < numStages; ++s) {
+        auto& stage = stages[(size_t) s];
+        if (type == FilterType::minimumPhaseIIR)
+            designAllpass(stage, s == 0 ? firstAllpassCoefficients : laterAllpassCoefficients,
+                          s == 0 ? firstTransition : laterTransition);
+        else
+            designFIR(stage, 0, s == 0 ? firstTransition : laterTransition, firAttenuationDb);
+    }
+
+    // Latence aller-retour au rythme de base : chaque étage retarde la montée et la descente
+    // de delay échantillons de son rythme haut (2^(s+1) fois la base)
+    double total = 0.0;
+    for (int s = 0; s < numStages; ++s)
+        total += stages[(size_t) s].delay / (double) (1 << s);
+    paddingSamples = (int) std::lround((std::ceil(total - 1e-6) - total) * factor);
+    latency = (int) std::lround(total + (double) paddingSamples / factor);
+
+    groups.resize((size_t) ((numChannels + groupSize - 1) / groupSize));
+    for (auto& g : groups) {
+        g.a.assign((size_t) (blockSize * factor), Vec::expand((SampleType) 0));
+        g.b.assign((size_t) (blockSize * factor), Vec::expand((SampleType) 0));
+        for (int s = 0; s < numStages; ++s) {
+            const auto& stage = stages[(size_t) s];
+            auto& st = g.stages[(size_t) s];
+            for (size_t p = 0; p < 2; ++p) {
+                st.up[p].assign(stage.allpass[p].size(), AllpassState {});
+                st.down[p].assign(stage.allpass[p].size(), AllpassState {});
+            }
+            st.upHistory.prepare((int) stage.taps.size());
+            st.downEven.prepare((int) stage.taps.size());
+            st.downOdd.prepare(stage.centre / 2 + 2);
+        }
+        g.padding.prepare(paddingSamples + 1);
+    }
+    oversampled.assign((size_t) numChannels, std::vector<SampleType>((size_t) (blockSize * factor), (SampleType) 0));
+    reset();
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::reset() noexcept
+{
+    const auto zero = Vec::expand((SampleType) 0);
+    for (auto& g : groups) {
+        for (auto& st : g.stages) {
+            for (auto* branches : { &st.up, &st.down })
+                for (auto& branch : *branches)
+                    for (auto& s : branch)
+                        s = { zero, zero };
+            st.upHistory.clear();
+            st.downEven.clear();
+            st.downOdd.clear();
+            st.previousOdd = zero;
+        }
+        g.padding.clear();
+    }
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::upStage(const Stage& stage, StageState& state, const Vec* in, Vec* out, int numIn) const noexcept
+{
+    if (filterType == FilterType::minimumPhaseIIR) {
+        // Sortie paire : branche 0, impaire : branche 1, toutes deux au rythme d'entrée
+        for (size_t p = 0; p < 2; ++p) {
+            const auto& coeffs = stage.allpass[p];
+            auto& sections = state.up[p];
+            for (int n = 0; n < numIn; ++n) {
+                auto x = in[n];
+                for (size_t k = 0; k < coeffs.size(); ++k) {
+                    auto& s = sections[k];
+                    const auto y = Vec::expand(coeffs[k]) * (x - s.y1) + s.x1;
+                    s.x1 = x;
+                    s.y1 = y;
+                    x = y;
+                }
+                out[2 * n + (int) p] = x;
+            }
+        }
+        return;
+    }
+
+    // FIR : sortie paire filtrée (coefficients x 2, gain de l'insertion de zéros), impaire = entrée retardée
+    const int numTaps = (int) stage.taps.size();
+    const int centreDelay = stage.centre / 2;
+    const auto two = Vec::expand((SampleType) 2);
+    auto& history = state.upHistory;
+    for (int n = 0; n < numIn; ++n) {
+        history.push(in[n]);
+        const Vec* h = history.get();
+        auto acc = Vec::expand(stage.taps[0]) * h[0];
+        for (int i = 1; i < numTaps; ++i)
+            acc = acc + Vec::expand(stage.taps[(size_t) i]) * h[i];
+        out[2 * n] = acc * two;
+        out[2 * n + 1] = h[centreDelay];
+    }
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::downStage(const Stage& stage, StageState& state, const Vec* in, Vec* out, int numOut) const noexcept
+{
+    const auto half = Vec::expand((SampleType) 0.5);
+
+    if (filterType == FilterType::minimumPhaseIIR) {
+        // Branche 0 sur les échantillons pairs, branche 1 sur les impairs retardés d'un échantillon
+        for (int n = 0; n < numOut; ++n) {
+            std::array<Vec, 2> x { in[2 * n], state.previousOdd };
+            state.previousOdd = in[2 * n + 1];
+            for (size_t p = 0; p < 2; ++p) {
+                const auto& coeffs = stage.allpass[p];
+                auto& sections = state.down[p];
+                for (size_t k = 0; k < coeffs.size(); ++k) {
+                    auto& s = sections[k];
+                    const auto y = Vec::expand(coeffs[k]) * (x[p] - s.y1) + s.x1;
+                    s.x1 = x[p];
+                    s.y1 = y;
+                    x[p] = y;
+                }
+            }
+            out[n] = (x[0] + x[1]) * half;
+        }
+        return;
+    }
+
+    // FIR : coefficients sur les pairs, centre (1/2) sur l'impair retardé de centre / 2 + 1
+    const int numTaps = (int) stage.taps.size();
+    const int centreDelay = stage.centre / 2;
+    for (int n = 0; n < numOut; ++n) {
+        state.downEven.push(in[2 * n]);
+        const Vec* e = state.downEven.get();
+        auto acc = Vec::expand(stage.taps[0]) * e[0];
+        for (int i = 1; i < numTaps; ++i)
+            acc = acc + Vec::expand(stage.taps[(size_t) i]) * e[i];
+        out[n] = acc + state.downOdd.get()[centreDelay] * half;
+        state.downOdd.push(in[2 * n + 1]);
+    }
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::processUp(const SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    assert(numSamples <= blockSize && numChannels <= (int) oversampled.size());
+    numSamples = std::min(numSamples, blockSize);
+    numChannels = std::min(numChannels, (int) oversampled.size());
+    alignas(16 * sizeof(float)) SampleType frame[Vec::SIMDNumElements] = {};
+
+    for (int first = 0, gi = 0; first < numChannels; first += groupSize, ++gi) {
+        auto& g = groups[(size_t) gi];
+        const int count = std::min(groupSize, numChannels - first);
+
+        // Canaux -> une lane par canal
+        for (int i = 0; i < numSamples; ++i) {
+            for (int ch = 0; ch < count; ++ch)
+                frame[ch] = channels[first + ch][i];
+            g.a[(size_t) i] = Vec::fromRawArray(frame);
+        }
+
+        Vec* in = g.a.data();
+        Vec* out = g.b.data();
+        int length = numSamples;
+        for (size_t s = 0; s < stages.size(); ++s) {
+            upStage(stages[s], g.stages[s], in, out, length);
+            length *= 2;
+            std::swap(in, out);
+        }
+
+        // Complément de latence, puis une lane -> un canal contigu
+        for (int i = 0; i < length; ++i) {
+            g.padding.push(in[i]);
+            g.padding.get()[paddingSamples].copyToRawArray(frame);
+            for (int ch = 0; ch < count; ++ch)
+                oversampled[(size_t) (first + ch)][(size_t) i] = frame[ch];
+        }
+    }
+}
+
+template <typename SampleType>
+void HalfBandOversampler<SampleType>::processDown(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    assert(numSamples <= blockSize && numChannels <= (int) oversampled.size());
+    numSamples = std::min(numSamples, blockSize);
+    numChannels = std::min(numChannels, (int) oversampled.size());
+    const int length = numSamples * getFactor();
+    alignas(16 * sizeof(float)) SampleType frame[Vec::SIMDNumElements] = {};
+
+    for (int first = 0, gi = 0; first < numChannels; first += groupSize, ++gi) {
+        auto& g = groups[(size_t) gi];
+        const int count = std::min(groupSize, numChannels - first);
+
+        for (int i = 0; i < length; ++i) {
+            for (int ch = 0; ch < count; ++ch)
+                frame[ch] = oversampled[(size_t) (first + ch)][(size_t) i];
+            g.a[(size_t) i] = Vec::fromRawArray(frame);
+        }
+
+        Vec* in = g.a.data();
+        Vec* out = g.b.data();
+        int numOut = length;
+        for (size_t s = stages.size(); s-- > 0;) {
+            numOut /= 2;
+            downStage(stages[s], g.stages[s], in, out, numOut);
+            std::swap(in, out);
+        }
+
+        for (int i = 0; i < numSamples; ++i) {
+            in[i].copyToRawArray(frame);
+            for (int ch = 0; ch < count; ++ch)
+                channels[first + ch][i] = frame[ch];
+        }
+    }
+}
+
+template class HalfBandOversampler<float>;
+template class HalfBandOversampler<double>;
@@ -0,0 +1,102 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "SIMDVector.h"
+
+// Suréchantillonnage 2x/4x/8x par étages demi-bande, sans JUCE.
+// Comme BiquadCascade, les canaux sont traités par groupes de groupSize, un canal par lane :
+// chaque étage filtre tout un groupe en une passe (une voie polyphase par registre SIMD).
+//  - minimumPhaseIIR : deux branches de passe-tout du 1er ordre (Valenzuela-Constantinides,
+//    coefficients elliptiques calculés comme dans HIIR), peu coûteux, phase non linéaire ;
+//  - linearPhaseFIR : FIR demi-bande (sinc fenêtré de Kaiser), un coefficient sur deux nul.
+// Les étages suivants, dont la bande utile n'occupe que le quart de leur entrée, sont plus courts.
+// La latence aller-retour est complétée au rythme suréchantillonné pour tomber sur un
+// nombre entier d'échantillons (exact en FIR ; en IIR, mesurée au continu, au demi-échantillon
+// suréchantillonné près).
+template <typename SampleType>
+class HalfBandOversampler
+{
+public:
+    using Vec = SIMDVector<SampleType>;
+    static constexpr int groupSize = (int) Vec::SIMDNumElements;
+    static constexpr int maxStages = 3;
+
+    enum class FilterType { minimumPhaseIIR = 0, linearPhaseFIR };
+
+    // Alloue tout (hors thread audio) pour numStages étages (facteur 2^numStages)
+    void prepare(int numChannels, int numStages, FilterType type, int maxBlockSize);
+    void reset() noexcept;
+
+    int getFactor() const noexcept { return 1 << (int) stages.size(); }
+    int getMaxBlockSize() const noexcept { return blockSize; }
+    int getLatencySamples() const noexcept { return latency; }
+
+    // Montée de numSamples <= getMaxBlockSize() échantillons ; résultat dans getOversampledChannel()
+    void processUp(const SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    // numSamples x facteur échantillons contigus par canal, modifiables avant la descente
+    SampleType* getOversampledChannel(int channel) noexcept { return oversampled[(size_t) channel].data(); }
+    // Descente du contenu de getOversampledChannel() vers channels (numSamples au rythme de base)
+    void processDown(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+private:
+    // Ligne à retard d'un groupe, doublée pour lire les dernières valeurs d'un bloc : [0] = la plus récente
+    struct History
+    {
+        std::vector<Vec> data;
+        int length = 0, pos = 0;
+
+        void prepare(int size);
+        void clear() noexcept;
+        void push(Vec v) noexcept
+        {
+            pos = pos == 0 ? length - 1 : pos - 1;
+            data[(size_t) pos] = data[(size_t) (pos + length)] = v;
+        }
+        const Vec* get() const noexcept { return data.data() + pos; }
+    };
+
+    // Passe-tout du 1er ordre au rythme de la branche : y = a (x - y1) + x1
+    struct AllpassState
+    {
+        Vec x1, y1;
+    };
+
+    struct Stage
+    {
+        // IIR : coefficients des deux branches (branche 1 retardée d'un échantillon)
+        std::array<std::vector<SampleType>, 2> allpass;
+        // FIR : coefficients non nuls de la phase filtrée (le centre vaut 1/2), retard du centre
+        std::vector<SampleType> taps;
+        int centre = 0;
+        // Retard (en échantillons du rythme de sortie de la montée) au continu
+        double delay = 0.0;
+    };
+
+    struct StageState
+    {
+        std::array<std::vector<AllpassState>, 2> up, down;
+        History upHistory, downEven, downOdd;
+        Vec previousOdd;
+    };
+
+    struct Group
+    {
+        std::vector<Vec> a, b;                  // tampons ping-pong, blockSize x facteur trames
+        std::array<StageState, maxStages> stages;
+        History padding;
+    };
+
+    static void designAllpass(Stage& stage, int numCoefficients, double transition);
+    static void designFIR(Stage& stage, int numTaps, double transition, double attenuationDb);
+
+    void upStage(const Stage& stage, StageState& state, const Vec* in, Vec* out, int numIn) const noexcept;
+    void downStage(const Stage& stage, StageState& state, const Vec* in, Vec* out, int numOut) const noexcept;
+
+    FilterType filterType = FilterType::minimumPhaseIIR;
+    std::vector<Stage> stages;
+    std::vector<Group> groups;
+    std::vector<std::vector<SampleType>> oversampled;
+    int blockSize = 0;
+    int paddingSamples = 0;             // au rythme suréchantillonné
+    int latency = 0;
+};
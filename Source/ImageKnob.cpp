@@ -1,21 +1,12 @@
 #include "ImageKnob.h"
 #include "JuceHeader.h"
-#include "BinaryData.h"
 
-juce::ReferenceCountedObjectPtr<juce::Typeface> ImageKnobLookAndFeel::upheavttTypeface;
-
-juce::Font ImageKnobLookAndFeel::getUpheavttFont(float size)
+ImageKnobLookAndFeel::ImageKnobLookAndFeel(const juce::Image& knobImage, juce::Typeface::Ptr valueTypeface)
+    : knobImg(knobImage), valueFont(valueTypeface)
 {
-    if (upheavttTypeface == nullptr)
-        upheavttTypeface = juce::Typeface::createSystemTypefaceFor(BinaryData::upheavtt_ttf, BinaryData::upheavtt_ttfSize);
-    juce::Font font(*upheavttTypeface);
-    font.setHeight(size);
-    return font;
+    valueFont.setHeight(14.0f);
 }
 
-ImageKnobLookAndFeel::ImageKnobLookAndFeel(const juce::Image& knobImage)
-    : knobImg(knobImage) {}
-
 void ImageKnobLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPosProportional,
                                             float /*rotaryStartAngle*/, float /*rotaryEndAngle*/, juce::Slider& slider)
 {
@@ -26,15 +17,36 @@ void ImageKnobLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int
     const float drawSize = imgSize * scale;
     const float imgX = cx - drawSize * 0.5f;
     const float imgY = cy - drawSize * 0.5f;
-    constexpr float startAngle = juce::degreesToRadians(0.0f);
-    constexpr float endAngle   = juce::degreesToRadians(270.0f);
-    float angle = startAngle + sliderPosProportional * (endAngle - startAngle);
 
-    // Dessin du knob image
-    g.saveState();
-    g.addTransform(juce::AffineTransform::rotation(angle, cx, cy));
-    g.drawImage(knobImg, imgX, imgY, drawSize, drawSize, 0, 0, knobImg.getWidth(), knobImg.getHeight());
-    g.restoreState();
+    // Dessin du knob image (rien tant que l'image n'est pas décodée)
+    if (knobImg.isValid()) {
+        const bool timing = filmstrips->isTiming();
+        const auto paintStart = timing ? juce::Time::getHighResolutionTicks() : 0;
+        const bool useFilmstrip = filmstrips->isEnabled();
+
+        if (useFilmstrip) {
+            // Frame pré-tournée à la résolution physique, copiée sans transformation ni rééchantillonnage
+            const float physicalScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+            const int framePixels = juce::jmax(1, juce::roundToInt(drawSize * physicalScale));
+            const auto frame = filmstrips->getFrame(knobImg, framePixels, KnobFilmstripCache::frameFor(sliderPosProportional));
+            const float px = std::round(cx * physicalScale - (float) framePixels * 0.5f);
+            const float py = std::round(cy * physicalScale - (float) framePixels * 0.5f);
+            g.drawImageTransformed(frame, juce::AffineTransform::translation(px, py).scaled(1.0f / physicalScale));
+        }
+        else {
+            constexpr float startAngle = juce::degreesToRadians(0.0f);
+            constexpr float endAngle   = juce::degreesToRadians(270.0f);
+            float angle = startAngle + sliderPosProportional * (endAngle - startAngle);
+
+            g.saveState();
+            g.addTransform(juce::AffineTransform::rotation(angle, cx, cy));
+            g.drawImage(knobImg, imgX, imgY, drawSize, drawSize, 0, 0, knobImg.getWidth(), knobImg.getHeight());
+            g.restoreState();
+        }
+
+        if (timing)
+            filmstrips->notePaint(useFilmstrip, juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - paintStart) * 1.0e6);
+    }
 
     // Affichage de la valeur (si demandé par le contexte du slider)
     // Affiche la valeur centrée SOUS le centre du knob, pour tous les sliders SAUF Mid Q
@@ -45,7 +57,7 @@ void ImageKnobLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int
         else
             valueText = juce::String(slider.getValue(), 1);
         g.setColour(juce::Colours::white);
-        g.setFont(getUpheavttFont(14.0f));
+        g.setFont(valueFont);
         int textHeight = 18;
         int yOffset = height / 2 + 15; // 15px sous le centre du knob
         g.drawFittedText(valueText, x, y + yOffset, width, textHeight, juce::Justification::centred, 1);
@@ -54,7 +66,7 @@ void ImageKnobLookAndFeel::drawRotarySlider(juce::Graphics& g, int x, int y, int
     else if (midQSliderPointer && &slider == midQSliderPointer && (slider.isMouseOverOrDragging() || slider.isMouseButtonDown() || slider.hasKeyboardFocus(true))) {
         juce::String valueText = juce::String(slider.getValue(), 2);
         g.setColour(juce::Colours::white);
-        g.setFont(getUpheavttFont(14.0f));
+        g.setFont(valueFont);
         int textHeight = 18;
         int yOffset = height / 2 + 15 - 10; // Décalage vers le haut de 10px
         g.drawFittedText(valueText, x, y + yOffset, width, textHeight, juce::Justification::centred, 1);
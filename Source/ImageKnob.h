@@ -1,18 +1,22 @@
 #pragma once
 #include <JuceHeader.h>
+#include "KnobFilmstrip.h"
 
-// LookAndFeel personnalisé pour knob image rotatif, sans aucun dessin JUCE par défaut
+// LookAndFeel personnalisé pour knob image rotatif, sans aucun dessin JUCE par défaut.
+// Le knob est copié depuis un filmstrip pré-tourné partagé (KnobFilmstripCache)
 class ImageKnobLookAndFeel : public juce::LookAndFeel_V4 {
 public:
-    ImageKnobLookAndFeel(const juce::Image& knobImage);
+    // Image et police partagées (EditorResources) : aucune copie de pixels
+    ImageKnobLookAndFeel(const juce::Image& knobImage, juce::Typeface::Ptr valueTypeface);
     void drawRotarySlider(juce::Graphics&, int x, int y, int width, int height, float sliderPosProportional,
                           float rotaryStartAngle, float rotaryEndAngle, juce::Slider&) override;
 
-    static juce::ReferenceCountedObjectPtr<juce::Typeface> upheavttTypeface;
-    static juce::Font getUpheavttFont(float size);
+    void setKnobImage(const juce::Image& knobImage) { knobImg = knobImage; }
     void setMidQSliderPointer(const juce::Slider* ptr) { midQSliderPointer = ptr; }
 
 private:
     juce::Image knobImg;
+    juce::Font valueFont;
+    juce::SharedResourcePointer<KnobFilmstripCache> filmstrips;
     const juce::Slider* midQSliderPointer = nullptr;
 };
@@ -0,0 +1,106 @@
+#include "KnobFilmstrip.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr float startAngle = juce::degreesToRadians(0.0f);
+    constexpr float endAngle   = juce::degreesToRadians(270.0f);
+}
+
+int KnobFilmstripCache::frameFor(float sliderPosProportional) noexcept
+{
+    return juce::jlimit(0, numFrames - 1, juce::roundToInt(sliderPosProportional * (float) (numFrames - 1)));
+}
+
+float KnobFilmstripCache::angleFor(int frame) noexcept
+{
+    return startAngle + (endAngle - startAngle) * (float) frame / (float) (numFrames - 1);
+}
+
+juce::Image KnobFilmstripCache::getFrame(const juce::Image& knobImage, int framePixels, int frame)
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    jassert(frame >= 0 && frame < numFrames);
+
+    auto& strip = getStrip(knobImage, framePixels);
+    auto& image = strip.frames[(size_t) frame];
+
+    if (!image.isValid()) {
+        image = renderFrame(knobImage, framePixels, frame);
+        stats.framesRendered++;
+        stats.bytesUsed += (juce::int64) framePixels * framePixels * 4;
+    }
+    strip.lastUse[(size_t) frame] = ++useCounter;
+
+    if (stats.bytesUsed > maxBytes)
+        evictLeastRecentlyUsed();
+
+    return image;
+}
+
+KnobFilmstripCache::Strip& KnobFilmstripCache::getStrip(const juce::Image& knobImage, int framePixels)
+{
+    for (auto& s : strips)
+        if (s->source == knobImage.getPixelData() && s->framePixels == framePixels)
+            return *s;
+
+    auto s = std::make_unique<Strip>();
+    s->source = knobImage.getPixelData();
+    s->framePixels = framePixels;
+    strips.push_back(std::move(s));
+    return *strips.back();
+}
+
+juce::Image KnobFilmstripCache::renderFrame(const juce::Image& knobImage, int framePixels, int frame)
+{
+    // Même rendu que l'ancien drawRotarySlider, fait une fois en haute qualité
+    juce::Image image(juce::Image::ARGB, framePixels, framePixels, true);
+    juce::Graphics g(image);
+    g.setImageResamplingQuality(juce::Graphics::highResamplingQuality);
+
+    const float size = (float) framePixels;
+    g.addTransform(juce::AffineTransform::rotation(angleFor(frame), size * 0.5f, size * 0.5f));
+    g.drawImage(knobImage, 0.0f, 0.0f, size, size, 0, 0, knobImage.getWidth(), knobImage.getHeight());
+    return image;
+}
+
+void KnobFilmstripCache::evictLeastRecentlyUsed()
+{
+    // Jamais la frame qu'on vient de servir (useCounter), elle est en cours de dessin
+    while (stats.bytesUsed > maxBytes) {
+        Strip* oldestStrip = nullptr;
+        size_t oldestFrame = 0;
+        juce::uint64 oldestUse = useCounter;
+
+        for (auto& s : strips)
+            for (size_t f = 0; f < s->frames.size(); ++f)
+                if (s->frames[f].isValid() && s->lastUse[f] < oldestUse) {
+                    oldestStrip = s.get();
+                    oldestFrame = f;
+                    oldestUse = s->lastUse[f];
+                }
+
+        if (oldestStrip == nullptr)
+            return;
+
+        oldestStrip->frames[oldestFrame] = {};
+        stats.bytesUsed -= (juce::int64) oldestStrip->framePixels * oldestStrip->framePixels * 4;
+    }
+
+    // Bandes vides (ancienne taille d'éditeur) : libère aussi la référence à l'image source
+    strips.erase(std::remove_if(strips.begin(), strips.end(), [](const auto& s) {
+        return std::none_of(s->frames.begin(), s->frames.end(), [](const juce::Image& f) { return f.isValid(); });
+    }), strips.end());
+}
+
+void KnobFilmstripCache::notePaint(bool usedFilmstrip, double microseconds) noexcept
+{
+    if (usedFilmstrip) {
+        stats.filmstripPaints++;
+        stats.filmstripMicroseconds += microseconds;
+    }
+    else {
+        stats.directPaints++;
+        stats.directMicroseconds += microseconds;
+    }
+}
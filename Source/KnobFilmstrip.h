@@ -0,0 +1,66 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// Filmstrips de knobs pré-tournés, partagés par tous les éditeurs (juce::SharedResourcePointer).
+// Une bande = une image de knob à une taille en pixels physiques : les éditeurs de taille
+// ou d'échelle d'affichage différentes ont chacun leurs frames nettes, sans rééchantillonnage.
+// Les frames sont rendues à la demande (seules les positions réellement affichées coûtent)
+// et les moins récemment utilisées sont libérées au-delà de maxBytes.
+// Thread de message uniquement, comme le dessin des LookAndFeel.
+class KnobFilmstripCache
+{
+public:
+    static constexpr int numFrames = 128;                       // pas de 270° / 127 ≈ 2.1°
+    static constexpr juce::int64 maxBytes = 48 * 1024 * 1024;
+
+    // Temps de dessin d'un knob, pour comparer filmstrip et rotation directe
+    struct Stats
+    {
+        juce::int64 framesRendered = 0;
+        juce::int64 bytesUsed = 0;
+        juce::int64 filmstripPaints = 0, directPaints = 0;
+        double filmstripMicroseconds = 0.0, directMicroseconds = 0.0;   // cumulés
+
+        double averageFilmstripMicroseconds() const { return filmstripPaints > 0 ? filmstripMicroseconds / (double) filmstripPaints : 0.0; }
+        double averageDirectMicroseconds() const    { return directPaints > 0 ? directMicroseconds / (double) directPaints : 0.0; }
+    };
+
+    static int frameFor(float sliderPosProportional) noexcept;
+    static float angleFor(int frame) noexcept;
+
+    // Frame carrée de framePixels pixels physiques, knob centré et tourné de angleFor(frame)
+    juce::Image getFrame(const juce::Image& knobImage, int framePixels, int frame);
+
+    // false : rotation à chaque paint (ancien chemin), pour mesurer l'écart
+    void setEnabled(bool shouldUseFilmstrips) noexcept { enabled = shouldUseFilmstrips; }
+    bool isEnabled() const noexcept { return enabled; }
+
+    // Les paints ne sont chronométrés que tant qu'une vue affiche les Stats (surcouche de mesures)
+    void addViewer() noexcept { ++numViewers; }
+    void removeViewer() noexcept { --numViewers; }
+    bool isTiming() const noexcept { return numViewers > 0; }
+
+    void notePaint(bool usedFilmstrip, double microseconds) noexcept;
+    const Stats& getStats() const noexcept { return stats; }
+
+private:
+    struct Strip
+    {
+        juce::ImagePixelData::Ptr source;         // identité de l'image du knob, gardée en vie
+        int framePixels = 0;
+        std::array<juce::Image, numFrames> frames;
+        std::array<juce::uint64, numFrames> lastUse {};
+    };
+
+    Strip& getStrip(const juce::Image& knobImage, int framePixels);
+    static juce::Image renderFrame(const juce::Image& knobImage, int framePixels, int frame);
+    void evictLeastRecentlyUsed();
+
+    std::vector<std::unique_ptr<Strip>> strips;
+    juce::uint64 useCounter = 0;
+    bool enabled = true;
+    int numViewers = 0;
+    Stats stats;
+};
@@ -0,0 +1,282 @@
+#include "LinearPhaseEQ.h"
+#include <complex>
+
+namespace
+{
+    bool sameParameters(const EQParameters& a, const EQParameters& b) noexcept
+    {
+        return a.lowGain == b.lowGain && a.midGain == b.midGain && a.highGain == b.highGain && a.midQ == b.midQ;
+    }
+}
+
+// Thread unique pour tout le process, comme celui de CoefficientUpdater : il sonde
+// les instances enregistrées et ne conçoit que pour celles en mode phase linéaire
+// dont un paramètre a bougé.
+struct LinearPhaseEQ::DesignThread : public juce::Thread
+{
+    DesignThread() : juce::Thread("MerjEQ linear-phase designer") { startThread(); }
+    ~DesignThread() override { stopThread(1000); }
+
+    void add(LinearPhaseEQ* e)
+    {
+        const juce::ScopedLock sl(lock);
+        clients.addIfNotAlreadyThere(e);
+    }
+
+    void remove(LinearPhaseEQ* e)
+    {
+        const juce::ScopedLock sl(lock);
+        clients.removeFirstMatchingValue(e);
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit()) {
+            {
+                const juce::ScopedLock sl(lock);
+                for (auto* e : clients)
+                    e->service();
+            }
+            wait(5);
+        }
+    }
+
+    // Verrou partagé entre thread de message et thread de conception uniquement
+    juce::CriticalSection lock;
+    juce::Array<LinearPhaseEQ*> clients;
+};
+
+LinearPhaseEQ::LinearPhaseEQ(CoefficientUpdater& parameterSource)
+    : parameters(parameterSource)
+{
+    designThread->add(this);
+}
+
+LinearPhaseEQ::~LinearPhaseEQ()
+{
+    designThread->remove(this);
+}
+
+void LinearPhaseEQ::prepare(double sampleRate, int numChannels)
+{
+    const juce::ScopedLock sl(designLock);
+
+    kernelLength = juce::nextPowerOfTwo(juce::roundToInt(sampleRate * kernelSeconds));
+    blockSize = kernelLength / numPartitions;
+    numVecBins = (blockSize + 1 + (int) Vec::SIMDNumElements - 1) / (int) Vec::SIMDNumElements;
+    numChannelsPrepared = juce::jmax(1, numChannels);
+
+    const int order = juce::roundToInt(std::log2((double) kernelLength));
+    designFFT = std::make_unique<juce::dsp::FFT>(order);
+    designPartitionFFT = std::make_unique<juce::dsp::FFT>(order - 2);    // 2 blocs = kernelLength / 4
+    fft = std::make_unique<juce::dsp::FFT>(order - 2);
+
+    // Hann périodique : maximum exactement au centre kernelLength / 2, symétrique autour
+    designWindow.resize((size_t) kernelLength);
+    for (int n = 0; n < kernelLength; ++n)
+        designWindow[(size_t) n] = (float) (0.5 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * n / kernelLength));
+    designBuffer.assign((size_t) kernelLength * 2, 0.0f);
+    designPartitionBuffer.assign((size_t) blockSize * 4, 0.0f);
+
+    Kernel blank;
+    blank.re.assign((size_t) (numPartitions * numVecBins), Vec::expand(0.0f));
+    blank.im = blank.re;
+    designRate = sampleRate;
+    designedParams = parameters.getParameters();
+    design(designedParams, blank);
+    current = blank;
+    previous = blank;
+    handover.resetAll(blank);
+
+    input.assign((size_t) (numChannelsPrepared * blockSize * 2), 0.0f);
+    output.assign((size_t) (numChannelsPrepared * blockSize), 0.0f);
+    fadeOutput.assign((size_t) blockSize, 0.0f);
+    fftBuffer.assign((size_t) blockSize * 4, 0.0f);
+    fdlRe.assign((size_t) (numChannelsPrepared * numPartitions * numVecBins), Vec::expand(0.0f));
+    fdlIm = fdlRe;
+    accRe.assign((size_t) numVecBins, Vec::expand(0.0f));
+    accIm = accRe;
+
+    latencySamples = kernelLength / 2 + blockSize;
+    reset();
+}
+
+void LinearPhaseEQ::reset() noexcept
+{
+    std::fill(input.begin(), input.end(), 0.0f);
+    std::fill(output.begin(), output.end(), 0.0f);
+    std::fill(fdlRe.begin(), fdlRe.end(), Vec::expand(0.0f));
+    std::fill(fdlIm.begin(), fdlIm.end(), Vec::expand(0.0f));
+    blockPos = 0;
+    fdlPos = 0;
+    fading = false;
+}
+
+void LinearPhaseEQ::service() noexcept
+{
+    if (!active.load(std::memory_order_relaxed))
+        return;
+    const juce::ScopedLock sl(designLock);
+    designIfChanged();
+}
+
+void LinearPhaseEQ::designPending() noexcept
+{
+    const juce::ScopedLock sl(designLock);
+    designIfChanged();
+}
+
+bool LinearPhaseEQ::designIfChanged() noexcept
+{
+    const auto params = parameters.getParameters();
+    if (designRate <= 0.0 || sameParameters(params, designedParams))
+        return false;
+
+    design(params, handover.getWriteBuffer());
+    handover.publish();
+    designedParams = params;
+    return true;
+}
+
+void LinearPhaseEQ::design(const EQParameters& params, Kernel& dest) noexcept
+{
+    // Amplitude de la cascade IIR (mêmes coefficients que updateFilters) à phase nulle
+    std::array<BiquadCoefficients, EQBands::numBands> bands;
+    for (int b = 0; b < EQBands::numBands; ++b)
+        bands[(size_t) b] = table->makeBand(b, designRate, params);
+
+    const int half = kernelLength / 2;
+    auto& d = designBuffer;
+    for (int k = 0; k <= half; ++k) {
+        const auto z1 = std::polar(1.0, -juce::MathConstants<double>::twoPi * k / kernelLength);
+        const auto z2 = z1 * z1;
+        double magnitude = 1.0;
+        for (auto& c : bands)
+            magnitude *= std::abs(((double) c.b0 + (double) c.b1 * z1 + (double) c.b2 * z2)
+                                  / (1.0 + (double) c.a1 * z1 + (double) c.a2 * z2));
+        d[(size_t) (2 * k)] = (float) magnitude;
+        d[(size_t) (2 * k + 1)] = 0.0f;
+    }
+    std::fill(d.begin() + 2 * (half + 1), d.end(), 0.0f);
+    designFFT->performRealOnlyInverseTransform(d.data());
+
+    // Réponse centrée en kernelLength / 2 (retard entier, symétrique), fenêtrée, puis
+    // découpée en partitions de blockSize complétées de zéros, passées dans le domaine fréquentiel
+    auto& pb = designPartitionBuffer;
+    for (int p = 0; p < numPartitions; ++p) {
+        std::fill(pb.begin(), pb.end(), 0.0f);
+        for (int n = 0; n < blockSize; ++n) {
+            const int index = p * blockSize + n;
+            pb[(size_t) n] = d[(size_t) ((index + half) & (kernelLength - 1))] * designWindow[(size_t) index];
+        }
+        designPartitionFFT->performRealOnlyForwardTransform(pb.data(), true);
+
+        auto* re = reinterpret_cast<float*>(dest.re.data() + p * numVecBins);
+        auto* im = reinterpret_cast<float*>(dest.im.data() + p * numVecBins);
+        for (int k = 0; k < numVecBins * (int) Vec::SIMDNumElements; ++k) {
+            re[k] = k <= blockSize ? pb[(size_t) (2 * k)] : 0.0f;
+            im[k] = k <= blockSize ? pb[(size_t) (2 * k + 1)] : 0.0f;
+        }
+    }
+
+    dest.sampleRate = designRate;
+    dest.params = params;
+}
+
+void LinearPhaseEQ::process(float* const* channels, int numChannels, int numSamples) noexcept
+{
+    jassert(numChannels <= numChannelsPrepared);
+    numChannels = juce::jmin(numChannels, numChannelsPrepared);
+
+    for (int done = 0; done < numSamples;) {
+        const int n = juce::jmin(numSamples - done, blockSize - blockPos);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            // Entrée d'abord : la sortie réécrit le même buffer
+            juce::FloatVectorOperations::copy(input.data() + (ch * 2 + 1) * blockSize + blockPos, channels[ch] + done, n);
+            juce::FloatVectorOperations::copy(channels[ch] + done, output.data() + ch * blockSize + blockPos, n);
+        }
+        blockPos += n;
+        done += n;
+
+        if (blockPos == blockSize) {
+            processPartition(numChannels);
+            blockPos = 0;
+        }
+    }
+}
+
+void LinearPhaseEQ::processPartition(int numChannels) noexcept
+{
+    // Nouveau noyau : l'ancien reste en previous pour un fondu sur cette partition
+    if (!fading && handover.pull()) {
+        const auto& latest = handover.getReadBuffer();
+        if (latest.sampleRate == current.sampleRate) {
+            std::swap(current, previous);
+            current.re = latest.re;     // même taille : copie sans allocation
+            current.im = latest.im;
+            current.params = latest.params;
+            fading = true;
+        }
+    }
+
+    for (int ch = 0; ch < numChannels; ++ch) {
+        // Overlap-save : FFT des deux derniers blocs d'entrée, rangée dans la ligne à retard
+        auto* window = input.data() + ch * 2 * blockSize;
+        std::copy(window, window + 2 * blockSize, fftBuffer.begin());
+        std::fill(fftBuffer.begin() + 2 * blockSize, fftBuffer.end(), 0.0f);
+        fft->performRealOnlyForwardTransform(fftBuffer.data(), true);
+
+        auto* xr = reinterpret_cast<float*>(fdlRe.data() + (ch * numPartitions + fdlPos) * numVecBins);
+        auto* xi = reinterpret_cast<float*>(fdlIm.data() + (ch * numPartitions + fdlPos) * numVecBins);
+        for (int k = 0; k <= blockSize; ++k) {
+            xr[k] = fftBuffer[(size_t) (2 * k)];
+            xi[k] = fftBuffer[(size_t) (2 * k + 1)];
+        }
+
+        auto* out = output.data() + ch * blockSize;
+        convolve(ch, current, out);
+        if (fading) {
+            convolve(ch, previous, fadeOutput.data());
+            for (int i = 0; i < blockSize; ++i) {
+                const float r = (float) (i + 1) / (float) blockSize;
+                out[i] = fadeOutput[(size_t) i] + r * (out[i] - fadeOutput[(size_t) i]);
+            }
+        }
+
+        std::copy(window + blockSize, window + 2 * blockSize, window);
+    }
+
+    fdlPos = (fdlPos + 1) % numPartitions;
+    fading = false;
+}
+
+void LinearPhaseEQ::convolve(int channel, const Kernel& kernel, float* dest) noexcept
+{
+    // Somme sur les partitions de X(bloc - p) * H(p), bin par bin, plusieurs bins par registre
+    std::fill(accRe.begin(), accRe.end(), Vec::expand(0.0f));
+    std::fill(accIm.begin(), accIm.end(), Vec::expand(0.0f));
+
+    for (int p = 0; p < numPartitions; ++p) {
+        const int slot = (fdlPos - p + numPartitions) % numPartitions;
+        const auto* xr = fdlRe.data() + (channel * numPartitions + slot) * numVecBins;
+        const auto* xi = fdlIm.data() + (channel * numPartitions + slot) * numVecBins;
+        const auto* hr = kernel.re.data() + p * numVecBins;
+        const auto* hi = kernel.im.data() + p * numVecBins;
+        for (int k = 0; k < numVecBins; ++k) {
+            accRe[(size_t) k] += xr[k] * hr[k] - xi[k] * hi[k];
+            accIm[(size_t) k] += xr[k] * hi[k] + xi[k] * hr[k];
+        }
+    }
+
+    const auto* ar = reinterpret_cast<const float*>(accRe.data());
+    const auto* ai = reinterpret_cast<const float*>(accIm.data());
+    for (int k = 0; k <= blockSize; ++k) {
+        fftBuffer[(size_t) (2 * k)] = ar[k];
+        fftBuffer[(size_t) (2 * k + 1)] = ai[k];
+    }
+    std::fill(fftBuffer.begin() + 2 * (blockSize + 1), fftBuffer.end(), 0.0f);
+    fft->performRealOnlyInverseTransform(fftBuffer.data());
+
+    // Seule la seconde moitié est la convolution linéaire
+    std::copy(fftBuffer.begin() + blockSize, fftBuffer.begin() + 2 * blockSize, dest);
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include "CoefficientUpdater.h"
+#include "TripleBuffer.h"
+
+// Mode phase linéaire : FIR symétrique de même amplitude que les trois sections IIR,
+// appliqué par convolution FFT à partitions uniformes (overlap-save, ligne à retard
+// fréquentielle, multiplication-accumulation complexe en SIMD).
+// Le noyau fait kernelLength = ~85 ms (puissance de 2) et est découpé en numPartitions
+// blocs de kernelLength / numPartitions : le coût par échantillon dépend du nombre de
+// partitions et plus de la longueur du noyau, quelle que soit la fréquence.
+// Latence : kernelLength / 2 (centre du FIR) + une partition.
+// Les noyaux sont conçus par un thread partagé par toutes les instances quand les
+// paramètres bougent, publiés dans un triple buffer, et le thread audio passe de
+// l'ancien au nouveau par un fondu sur une partition.
+class LinearPhaseEQ
+{
+public:
+    static constexpr int numPartitions = 8;
+    static constexpr double kernelSeconds = 0.085;
+
+    explicit LinearPhaseEQ(CoefficientUpdater& parameterSource);
+    ~LinearPhaseEQ();
+
+    // Audio arrêté : dimensionne tout et conçoit le noyau des paramètres courants
+    void prepare(double sampleRate, int numChannels);
+    void reset() noexcept;
+    void process(float* const* channels, int numChannels, int numSamples) noexcept;
+
+    // Thread audio : le thread de conception ne travaille que pour les instances actives
+    void setActive(bool shouldBeActive) noexcept { active.store(shouldBeActive, std::memory_order_relaxed); }
+
+    // Thread audio en rendu offline : conçoit tout de suite si les paramètres ont bougé
+    // (attente du verrou de conception permise hors temps réel)
+    void designPending() noexcept;
+
+    int getLatencySamples() const noexcept { return latencySamples.load(); }
+    int getTailSamples() const noexcept { return kernelLength + blockSize; }
+
+    // Appelé par le thread de conception partagé
+    void service() noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+
+    struct Kernel
+    {
+        double sampleRate = 0.0;
+        EQParameters params;
+        std::vector<Vec> re, im;    // [partition][bin / largeur SIMD]
+    };
+
+    bool designIfChanged() noexcept;
+    void design(const EQParameters& params, Kernel& dest) noexcept;
+    void processPartition(int numChannels) noexcept;
+    void convolve(int channel, const Kernel& kernel, float* dest) noexcept;
+
+    CoefficientUpdater& parameters;
+    juce::SharedResourcePointer<CoefficientTable> table;
+
+    int kernelLength = 0, blockSize = 0, numVecBins = 0, numChannelsPrepared = 0;
+    std::atomic<int> latencySamples { 0 };
+    std::atomic<bool> active { false };
+
+    // === Conception (thread de conception, ou thread audio offline, sous designLock) ===
+    juce::CriticalSection designLock;
+    double designRate = 0.0;
+    EQParameters designedParams;
+    std::unique_ptr<juce::dsp::FFT> designFFT, designPartitionFFT;
+    std::vector<float> designWindow, designBuffer, designPartitionBuffer;
+    TripleBuffer<Kernel> handover;
+
+    // === Thread audio ===
+    std::unique_ptr<juce::dsp::FFT> fft;
+    Kernel current, previous;
+    bool fading = false;
+    std::vector<float> input, output, fftBuffer, fadeOutput;   // input : 2 blocs par canal, output : 1 bloc
+    std::vector<Vec> fdlRe, fdlIm, accRe, accIm;                // fdl : [canal][partition][bin]
+    int blockPos = 0, fdlPos = 0;
+
+    struct DesignThread;
+    juce::SharedResourcePointer<DesignThread> designThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LinearPhaseEQ)
+};
@@ -0,0 +1,287 @@
+#include "MerjEQCore.h"
+#include <cmath>
+#include <type_traits>
+
+namespace
+{
+    constexpr double eqFadeSeconds = 0.01;
+    constexpr double programFadeSeconds = 0.02;
+
+    bool sameParameters(const EQParameters& a, const EQParameters& b) noexcept
+    {
+        return a.lowGain == b.lowGain && a.midGain == b.midGain && a.highGain == b.highGain && a.midQ == b.midQ;
+    }
+}
+
+template <typename SampleType>
+MerjEQCore<SampleType>::MerjEQCore()
+{
+    prepare(sampleRate, 2, 512);
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::prepare(double newSampleRate, int numChannels, int maxBlockSize, int maxPartitions)
+{
+    sampleRate = newSampleRate;
+    numChannels = std::max(1, numChannels);
+    blockSize = std::max(1, maxBlockSize);
+
+    // Partitions de groupes SIMD entiers, aussi égales que possible
+    constexpr int groupSize = BiquadCascade<SampleType>::groupSize;
+    const int numGroups = (numChannels + groupSize - 1) / groupSize;
+    const int numPartitions = std::clamp(maxPartitions, 1, numGroups);
+    partitions.clear();
+    partitions.resize((size_t) numPartitions);
+    for (int p = 0; p < numPartitions; ++p) {
+        auto& partition = partitions[(size_t) p];
+        const int first = std::min(numChannels, numGroups * p / numPartitions * groupSize);
+        const int last = std::min(numChannels, numGroups * (p + 1) / numPartitions * groupSize);
+        partition.channels = { first, last - first };
+
+        partition.fusedCascade.prepare(last - first);
+        partition.fadeCascade.prepare(last - first);
+        partition.stateVariableEQ.setParameters(parameters.eq);
+        partition.stateVariableEQ.prepare(sampleRate, last - first);
+        partition.dynamicEQ.setParameters(parameters.eq, parameters.dynamics);
+        partition.dynamicEQ.prepare(sampleRate, last - first);
+    }
+
+    const auto storageSize = (size_t) numChannels * (size_t) blockSize;
+    dryStorage.assign(storageSize, (SampleType) 0);
+    fadeStorage.assign(storageSize, (SampleType) 0);
+    mixRamp.assign((size_t) blockSize, (SampleType) 0);
+    fadeRamp.assign((size_t) blockSize, (SampleType) 0);
+    dryPointers.resize((size_t) numChannels);
+    fadePointers.resize((size_t) numChannels);
+    segmentPointers.assign((size_t) numChannels, nullptr);
+    workPointers.assign((size_t) numChannels, nullptr);
+    for (size_t ch = 0; ch < (size_t) numChannels; ++ch) {
+        dryPointers[ch] = dryStorage.data() + ch * (size_t) blockSize;
+        fadePointers[ch] = fadeStorage.data() + ch * (size_t) blockSize;
+    }
+
+    if (!externalCoefficients)
+        designCascade(parameters.eq);
+
+    programFade.reset(sampleRate, programFadeSeconds);
+    programFade.setCurrentAndTargetValue(1.0f);
+    eqMix.reset(sampleRate, eqFadeSeconds);
+    resetBypass(isNeutral());
+    tailSamples = EQDesign::worstCaseTailSamples(sampleRate, silenceThreshold);
+    silentSamples = 0;
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::reset() noexcept
+{
+    for (auto& partition : partitions) {
+        partition.fusedCascade.reset();
+        partition.fadeCascade.reset();
+        partition.stateVariableEQ.reset();
+        partition.dynamicEQ.reset();
+    }
+    programFade.setCurrentAndTargetValue(1.0f);
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::setParameters(const Parameters& p) noexcept
+{
+    // Changement de moteur : on repart d'un état propre plutôt que d'un état périmé
+    if (p.engine != parameters.engine)
+        reset();
+
+    // Seul le moteur actif suit les paramètres (les autres ne lissent rien en attendant)
+    if (p.engine == Engine::stateVariable) {
+        for (auto& partition : partitions)
+            partition.stateVariableEQ.setParameters(p.eq);
+    } else if (p.engine == Engine::dynamic) {
+        for (auto& partition : partitions)
+            partition.dynamicEQ.setParameters(p.eq, p.dynamics);
+    } else if (!externalCoefficients && !sameParameters(p.eq, cascadeParameters))
+        designCascade(p.eq);
+
+    parameters = p;
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::setCoefficients(const EQCoefficientSet& set, bool crossfade) noexcept
+{
+    // Seule la cascade saute d'un jeu à l'autre : le SVF et le mode dynamique lissent leurs paramètres
+    if (crossfade && parameters.engine == Engine::fusedCascade) {
+        for (auto& partition : partitions)
+            partition.fadeCascade = partition.fusedCascade;   // même nombre de groupes : copie sans allocation
+        programFade.setCurrentAndTargetValue(0.0f);
+        programFade.setTargetValue(1.0f);
+    }
+    externalCoefficients = true;
+    applyCascade(set);
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::designCascade(const EQParameters& eq) noexcept
+{
+    EQCoefficientSet set;
+    set.sampleRate = sampleRate;
+    // Une conception par bande : en double, la version float (neutralité) en est l'arrondi
+    for (int b = 0; b < EQBands::numBands; ++b) {
+        if constexpr (std::is_same_v<SampleType, float>) {
+            set.bands[(size_t) b] = EQDesign::makeBand(b, sampleRate, eq);
+        } else {
+            set.preciseBands[(size_t) b] = EQDesign::makeBandPrecise(b, sampleRate, eq);
+            set.bands[(size_t) b] = EQDesign::toFloat(set.preciseBands[(size_t) b]);
+        }
+    }
+    cascadeParameters = eq;
+    applyCascade(set);
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::applyCascade(const EQCoefficientSet& set) noexcept
+{
+    for (auto& partition : partitions) {
+        for (int b = 0; b < EQBands::numBands; ++b) {
+            if constexpr (std::is_same_v<SampleType, float>)
+                partition.fusedCascade.setCoefficients(b, set.bands[(size_t) b]);
+            else
+                partition.fusedCascade.setCoefficients(b, set.preciseBands[(size_t) b]);
+        }
+    }
+    cascadeIsIdentity = set.isIdentity();
+}
+
+template <typename SampleType>
+bool MerjEQCore<SampleType>::isNeutral() const noexcept
+{
+    // Mêmes paramètres dans toutes les partitions : la première suffit
+    const auto& partition = partitions.front();
+    switch (parameters.engine) {
+        case Engine::stateVariable: return partition.stateVariableEQ.isNeutral();
+        case Engine::dynamic:       return partition.dynamicEQ.isNeutral();
+        case Engine::fusedCascade:
+        default:                    return cascadeIsIdentity;
+    }
+}
+
+template <typename SampleType>
+bool MerjEQCore<SampleType>::isSilent(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < numSamples; ++i)
+            if (std::abs(channels[ch][i]) >= (SampleType) silenceThreshold)
+                return false;
+    return true;
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::process(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    const SIMDNative::ScopedNoDenormals noDenormals;
+
+    // Entrée silencieuse : une fois la traîne écoulée, l'état interne est sous le seuil
+    // des dénormaux et la sortie reste nulle, il n'y a plus rien à calculer
+    if (isSilent(channels, numChannels, numSamples)) {
+        if (silentSamples >= tailSamples)
+            return;
+        silentSamples += numSamples;
+    } else {
+        silentSamples = 0;
+    }
+
+    const bool bypassed = processWithBypass(channels, numChannels, numSamples, isNeutral(),
+                                            [this](SampleType* const* c, int nc, int ns) { processEQ(c, nc, ns); });
+    processSaturation(channels, numChannels, numSamples);
+
+    // Contournement atteint ou traîne écoulée : l'état repart exactement de zéro
+    if (bypassed || silentSamples >= tailSamples)
+        reset();
+}
+
+template <typename SampleType>
+template <typename Function>
+void MerjEQCore<SampleType>::forEachPartition(int numChannels, Function&& fn) const noexcept
+{
+    // Les workers du pool tournent déjà en FTZ/DAZ : même résultat que sur le thread appelant
+    WorkStealingPool::forEach(partitions.size() > 1 ? workerPool : nullptr, (int) partitions.size(), [&](int index) {
+        const auto range = partitions[(size_t) index].channels;
+        const int count = std::min(range.numChannels, numChannels - range.firstChannel);
+        if (count > 0)
+            fn(index, range.firstChannel, count);
+    });
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::processEQ(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    // Fondu de preset en cours : ancienne et nouvelle cascade côte à côte
+    if (parameters.engine == Engine::fusedCascade && programFade.isSmoothing()) {
+        processProgramFade(channels, numChannels, numSamples);
+        return;
+    }
+
+    forEachPartition(numChannels, [&](int index, int first, int count) {
+        auto& partition = partitions[(size_t) index];
+        switch (parameters.engine) {
+            case Engine::stateVariable:
+                partition.stateVariableEQ.process(channels + first, count, numSamples);
+                break;
+            case Engine::dynamic:
+                partition.dynamicEQ.process(channels + first, count, numSamples);
+                break;
+            case Engine::fusedCascade:
+            default:
+                // Une seule passe, les 3 bandes enchaînées par échantillon, canaux par groupes SIMD
+                partition.fusedCascade.process(channels + first, count, numSamples);
+                break;
+        }
+    });
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::processProgramFade(SampleType* const* channels, int numChannels, int numSamples) noexcept
+{
+    assert(numChannels <= (int) workPointers.size());
+    numChannels = std::min(numChannels, (int) workPointers.size());
+
+    for (int pos = 0; pos < numSamples;) {
+        const int n = std::min(numSamples - pos, blockSize);
+        for (int i = 0; i < n; ++i)
+            fadeRamp[(size_t) i] = (SampleType) programFade.getNextValue();
+
+        // Chaque partition n'écrit que dans ses canaux de workPointers et fadePointers
+        forEachPartition(numChannels, [&](int index, int first, int count) {
+            auto& partition = partitions[(size_t) index];
+            auto* work = workPointers.data() + first;
+            auto* fade = fadePointers.data() + first;
+            for (int ch = 0; ch < count; ++ch) {
+                work[ch] = channels[first + ch] + pos;
+                std::copy(work[ch], work[ch] + n, fade[ch]);
+            }
+            partition.fadeCascade.process(fade, count, n);
+            partition.fusedCascade.process(work, count, n);
+
+            for (int ch = 0; ch < count; ++ch) {
+                // sortie = ancien + fondu * (nouveau - ancien)
+                auto* out = work[ch];
+                const auto* old = fade[ch];
+                for (int i = 0; i < n; ++i)
+                    out[i] = (out[i] - old[i]) * fadeRamp[(size_t) i] + old[i];
+            }
+        });
+        pos += n;
+    }
+}
+
+template <typename SampleType>
+void MerjEQCore<SampleType>::processSaturation(SampleType* const* channels, int numChannels, int numSamples) const noexcept
+{
+    // Saturation douce (tanh, +6 dB de drive), sans suréchantillonnage
+    if (!parameters.saturationEnabled)
+        return;
+    forEachPartition(numChannels, [&](int, int first, int count) {
+        for (int ch = first; ch < first + count; ++ch)
+            Waveshaper::processSoft(channels[ch], numSamples, (SampleType) Waveshaper::softDrive, parameters.saturationQuality);
+    });
+}
+
+template class MerjEQCore<float>;
+template class MerjEQCore<double>;
@@ -0,0 +1,179 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <vector>
+#include "BiquadCascade.h"
+#include "EQCoefficients.h"
+#include "StateVariableEQ.h"
+#include "DynamicEQ.h"
+#include "SmoothedParameter.h"
+#include "Waveshaper.h"
+#include "WorkStealingPool.h"
+
+// Paramètres du moteur (gains en dB, seuils en dB FS, temps en ms)
+struct MerjEQCoreParameters
+{
+    enum class Engine { fusedCascade = 0, stateVariable, dynamic };
+
+    EQParameters eq;
+    Engine engine = Engine::fusedCascade;
+    DynamicEQSettings dynamics;         // moteur dynamic uniquement
+    bool saturationEnabled = false;
+    Waveshaper::Quality saturationQuality = Waveshaper::Quality::high;
+};
+
+// Moteur DSP de MerjEQ, sans dépendance à JUCE (bibliothèque statique MerjEQCore, voir
+// CMakeLists.txt) : EQ 3 bandes (cascade biquad, SVF ou dynamique), contournement en fondu
+// quand l'EQ est neutre, fondu entre deux jeux de coefficients de la cascade, saturation
+// douce et arrêt sur entrée silencieuse une fois la traîne écoulée.
+// Tout est alloué dans prepare() : setParameters(), setCoefficients() et process()
+// n'allouent rien et ne prennent aucun verrou.
+// Les canaux peuvent être découpés en partitions (groupes SIMD entiers), chacune avec
+// ses propres filtres : traitées à la suite, ou en parallèle sur un WorkStealingPool.
+// Toutes reçoivent les mêmes paramètres, le résultat est identique dans les deux cas.
+// Le plugin l'enrobe et y ajoute ce qui dépend de JUCE : paramètres de l'hôte, filtres
+// JUCE d'origine, phase linéaire (FFT) et suréchantillonnage de la saturation.
+template <typename SampleType>
+class MerjEQCore
+{
+public:
+    using Parameters = MerjEQCoreParameters;
+    using Engine = Parameters::Engine;
+
+    // Sous le plus petit float normalisé : silence, et seuil des traînes
+    static constexpr float silenceThreshold = std::numeric_limits<float>::min();
+
+    // Canaux [firstChannel, firstChannel + numChannels) d'une partition
+    struct ChannelRange { int firstChannel = 0, numChannels = 0; };
+
+    MerjEQCore();
+
+    // Alloue l'état pour numChannels canaux et des blocs d'au plus maxBlockSize
+    // échantillons (process() accepte des blocs plus longs, traités par morceaux).
+    // maxPartitions > 1 : canaux répartis en autant de partitions, au plus une par groupe SIMD
+    void prepare(double sampleRate, int numChannels, int maxBlockSize, int maxPartitions = 1);
+
+    int getNumPartitions() const noexcept { return (int) partitions.size(); }
+    ChannelRange getPartition(int index) const noexcept { return partitions[(size_t) index].channels; }
+
+    // Pool sur lequel traiter les partitions (nullptr : à la suite, sur le thread appelant).
+    // Peut changer entre deux process() ; le pool doit survivre au moteur ou être retiré avant.
+    void setWorkerPool(WorkStealingPool* pool) noexcept { workerPool = pool; }
+
+    // Remet les filtres à zéro (changement de moteur, fin de traîne)
+    void reset() noexcept;
+
+    // Nouvelles valeurs : le SVF et le mode dynamique les lissent eux-mêmes ; la cascade
+    // est reconçue quand les gains changent (EQDesign, sans allocation), sauf si l'appelant
+    // fournit ses coefficients. Changer de moteur remet les filtres à zéro.
+    void setParameters(const Parameters& params) noexcept;
+    const Parameters& getParameters() const noexcept { return parameters; }
+
+    // Coefficients de la cascade conçus par l'appelant (tables partagées, conception en tâche
+    // de fond, presets) : setParameters() ne les reconçoit plus ensuite.
+    // crossfade : l'ancienne cascade (état compris) continue pendant un fondu de 20 ms
+    void setCoefficients(const EQCoefficientSet& set, bool crossfade = false) noexcept;
+
+    // L'EQ du moteur courant laisse passer le signal tel quel
+    bool isNeutral() const noexcept;
+
+    // Fixe le contournement sans fondu (prepare() le fait d'après isNeutral() ; un hôte
+    // qui ajoute ses propres moteurs le corrige ensuite)
+    void resetBypass(bool neutral) noexcept { eqMix.setCurrentAndTargetValue(neutral ? 0.0f : 1.0f); }
+
+    // Pire traîne de l'EQ à la fréquence préparée
+    int getTailSamples() const noexcept { return tailSamples; }
+
+    // Chaîne complète, en place : EQ (contourné en fondu s'il est neutre) puis saturation
+    void process(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    // === Étapes séparées, pour un hôte qui intercale ses propres traitements ===
+    void processEQ(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    void processSaturation(SampleType* const* channels, int numChannels, int numSamples) const noexcept;
+
+    // Fondu de contournement (10 ms) autour d'un EQ quelconque, appelé comme
+    // eq(channels, numChannels, numSamples) sur des segments d'au plus maxBlockSize.
+    // Renvoie true quand le contournement vient d'être atteint : l'appelant remet alors
+    // ses filtres à zéro, pour repartir d'un état propre au prochain fondu entrant.
+    template <typename EQFunction>
+    bool processWithBypass(SampleType* const* channels, int numChannels, int numSamples,
+                           bool neutral, EQFunction&& eq) noexcept;
+
+private:
+    // Filtres d'une partition de canaux
+    struct Partition
+    {
+        ChannelRange channels;
+        BiquadCascade<SampleType> fusedCascade, fadeCascade;
+        StateVariableEQ<SampleType> stateVariableEQ;
+        DynamicEQ<SampleType> dynamicEQ;
+    };
+
+    void designCascade(const EQParameters& eq) noexcept;
+    void applyCascade(const EQCoefficientSet& set) noexcept;
+    void processProgramFade(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    static bool isSilent(SampleType* const* channels, int numChannels, int numSamples) noexcept;
+
+    // fn(index, firstChannel, numChannels) pour chaque partition ayant des canaux dans
+    // [0, numChannels), sur le pool s'il y en a un
+    template <typename Function>
+    void forEachPartition(int numChannels, Function&& fn) const noexcept;
+
+    Parameters parameters;
+    std::vector<Partition> partitions;
+    WorkStealingPool* workerPool = nullptr;
+    EQParameters cascadeParameters;      // conçus par le moteur (sans coefficients externes)
+    bool cascadeIsIdentity = true;
+    bool externalCoefficients = false;
+
+    SmoothedParameter<> eqMix;            // 0 = signal sec, 1 = EQ
+    SmoothedParameter<> programFade;      // 0 = ancienne cascade, 1 = nouvelle
+
+    // Buffers de travail, un bloc de blockSize par canal
+    std::vector<SampleType> dryStorage, fadeStorage, mixRamp, fadeRamp;
+    std::vector<SampleType*> dryPointers, fadePointers, segmentPointers, workPointers;
+
+    double sampleRate = 44100.0;
+    int blockSize = 0;
+    int tailSamples = 0;
+    int silentSamples = 0;
+};
+
+template <typename SampleType>
+template <typename EQFunction>
+bool MerjEQCore<SampleType>::processWithBypass(SampleType* const* channels, int numChannels, int numSamples,
+                                               bool neutral, EQFunction&& eq) noexcept
+{
+    assert(numChannels <= (int) dryPointers.size());
+    numChannels = std::min(numChannels, (int) dryPointers.size());
+
+    eqMix.setTargetValue(neutral ? 0.0f : 1.0f);
+    if (!eqMix.isSmoothing()) {
+        if (eqMix.getTargetValue() > 0.0f)
+            eq(channels, numChannels, numSamples);
+        return false;
+    }
+
+    for (int pos = 0; pos < numSamples;) {
+        const int n = std::min(numSamples - pos, blockSize);
+        for (int ch = 0; ch < numChannels; ++ch) {
+            segmentPointers[(size_t) ch] = channels[ch] + pos;
+            std::copy(channels[ch] + pos, channels[ch] + pos + n, dryPointers[(size_t) ch]);
+        }
+
+        eq(segmentPointers.data(), numChannels, n);
+
+        for (int i = 0; i < n; ++i)
+            mixRamp[(size_t) i] = (SampleType) eqMix.getNextValue();
+        for (int ch = 0; ch < numChannels; ++ch) {
+            // sortie = sec + mix * (EQ - sec)
+            auto* out = segmentPointers[(size_t) ch];
+            const auto* dry = dryPointers[(size_t) ch];
+            for (int i = 0; i < n; ++i)
+                out[i] = (out[i] - dry[i]) * mixRamp[(size_t) i] + dry[i];
+        }
+        pos += n;
+    }
+    return eqMix.getCurrentValue() == 0.0f;
+}
@@ -0,0 +1,128 @@
+#include "OversampledSaturator.h"
+
+template <typename SampleType>
+void OversampledSaturator<SampleType>::prepare(int numChannels, int maxBlockSize)
+{
+    const typename Oversampler::FilterType types[] = {
+        Oversampler::FilterType::minimumPhaseIIR,
+        Oversampler::FilterType::linearPhaseFIR
+    };
+
+    for (size_t t = 0; t < oversamplers.size(); ++t) {
+        for (size_t f = 0; f < oversamplers[t].size(); ++f) {
+            // Latence entière pour pouvoir la compenser chez l'hôte
+            auto os = std::make_unique<Oversampler>();
+            os->prepare(numChannels, (int) f + 1, types[t], maxBlockSize);
+            tailSamples[t][f] = measureTail(*os, numChannels);
+            oversamplers[t][f] = std::move(os);
+        }
+    }
+    channelPointers.assign((size_t) juce::jmax(1, numChannels), nullptr);
+    active = nullptr;
+}
+
+template <typename SampleType>
+int OversampledSaturator<SampleType>::measureTail(Oversampler& os, int numChannels)
+{
+    // Réponse impulsionnelle montée puis descendue, jusqu'au premier bloc entièrement nul
+    // (FTZ actif : les filtres IIR finissent par retomber exactement à zéro ; en double on
+    // s'arrête au même seuil qu'en float, le processeur remet les filtres à zéro ensuite)
+    juce::ScopedNoDenormals noDenormals;
+    constexpr int maxTail = 1 << 18;
+    const int blockSize = os.getMaxBlockSize();
+    const int latency = os.getLatencySamples();
+
+    juce::AudioBuffer<SampleType> scratch(numChannels, blockSize);
+    scratch.clear();
+    for (int ch = 0; ch < numChannels; ++ch)
+        scratch.setSample(ch, 0, (SampleType) 1);
+
+    int tail = 0;
+    for (int pos = 0; pos < maxTail; pos += blockSize) {
+        os.processUp(scratch.getArrayOfReadPointers(), numChannels, blockSize);
+        os.processDown(scratch.getArrayOfWritePointers(), numChannels, blockSize);
+
+        if (scratch.getMagnitude(0, blockSize) >= (SampleType) std::numeric_limits<float>::min())
+            tail = pos + blockSize;
+        else if (pos >= latency)
+            break;
+        scratch.clear();
+    }
+
+    os.reset();
+    return tail;
+}
+
+template <typename SampleType>
+int OversampledSaturator<SampleType>::getTailSamples(int factorIndex, FilterType type) const noexcept
+{
+    if (factorIndex <= 0 || factorIndex >= numFactors)
+        return 0;
+    return tailSamples[(size_t) type][(size_t) factorIndex - 1];
+}
+
+template <typename SampleType>
+void OversampledSaturator<SampleType>::reset()
+{
+    for (auto& row : oversamplers)
+        for (auto& os : row)
+            if (os != nullptr)
+                os->reset();
+}
+
+template <typename SampleType>
+typename OversampledSaturator<SampleType>::Oversampler* OversampledSaturator<SampleType>::get(int factorIndex, FilterType type) const noexcept
+{
+    if (factorIndex <= 0 || factorIndex >= numFactors)
+        return nullptr;
+    return oversamplers[(size_t) type][(size_t) factorIndex - 1].get();
+}
+
+template <typename SampleType>
+int OversampledSaturator<SampleType>::getLatencySamples(int factorIndex, FilterType type) const noexcept
+{
+    if (auto* os = get(factorIndex, type))
+        return os->getLatencySamples();
+    return 0;
+}
+
+template <typename SampleType>
+void OversampledSaturator<SampleType>::process(juce::dsp::AudioBlock<SampleType>& block, bool saturate, Waveshaper::Quality quality,
+                                               int factorIndex, FilterType type) noexcept
+{
+    auto* os = get(factorIndex, type);
+
+    // Nouveau réglage : on repart d'un état propre plutôt que d'un historique périmé
+    if (os != active) {
+        if (os != nullptr)
+            os->reset();
+        active = os;
+    }
+
+    const int numChannels = juce::jmin((int) block.getNumChannels(), (int) channelPointers.size());
+    const int numSamples = (int) block.getNumSamples();
+
+    if (os == nullptr) {
+        if (saturate)
+            for (int ch = 0; ch < numChannels; ++ch)
+                Waveshaper::processSoft(block.getChannelPointer((size_t) ch), numSamples, Waveshaper::softDrive, quality);
+        return;
+    }
+
+    // Tampons suréchantillonnés dimensionnés au prepare : l'hôte peut envoyer plus long
+    const int factor = os->getFactor();
+    for (int start = 0; start < numSamples; start += os->getMaxBlockSize()) {
+        const int n = juce::jmin(os->getMaxBlockSize(), numSamples - start);
+        for (int ch = 0; ch < numChannels; ++ch)
+            channelPointers[(size_t) ch] = block.getChannelPointer((size_t) ch) + start;
+
+        os->processUp(channelPointers.data(), numChannels, n);
+        if (saturate)
+            for (int ch = 0; ch < numChannels; ++ch)
+                Waveshaper::processSoft(os->getOversampledChannel(ch), n * factor, Waveshaper::softDrive, quality);
+        os->processDown(channelPointers.data(), numChannels, n);
+    }
+}
+
+template class OversampledSaturator<float>;
+template class OversampledSaturator<double>;
@@ -0,0 +1,47 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "HalfBandOversampler.h"
+#include "Waveshaper.h"
+
+// Réglages communs aux versions float et double
+struct OversampledSaturatorBase
+{
+    enum class FilterType { minimumPhaseIIR = 0, linearPhaseFIR };
+    static constexpr int numFactors = 4;     // 1x, 2x, 4x, 8x
+};
+
+// Étage de saturation suréchantillonné (1x/2x/4x/8x, IIR phase minimale ou FIR
+// phase linéaire, étages demi-bande SIMD de HalfBandOversampler). Tous les suréchantillonneurs
+// sont créés dans prepare() : changer de facteur pendant la lecture ne fait aucune allocation
+// sur le thread audio. Les blocs de l'hôte plus longs que maxBlockSize sont traités par morceaux.
+template <typename SampleType>
+class OversampledSaturator : public OversampledSaturatorBase
+{
+public:
+    void prepare(int numChannels, int maxBlockSize);
+    void reset();
+
+    // Latence (entière) introduite par un réglage donné
+    int getLatencySamples(int factorIndex, FilterType type) const noexcept;
+
+    // Durée (mesurée au prepare) pour que la réponse des filtres retombe sous le seuil des dénormaux
+    int getTailSamples(int factorIndex, FilterType type) const noexcept;
+
+    // Quand factorIndex > 0 le suréchantillonneur tourne même saturation coupée :
+    // la latence annoncée à l'hôte reste la même quand on active/désactive la saturation.
+    void process(juce::dsp::AudioBlock<SampleType>& block, bool saturate, Waveshaper::Quality quality,
+                 int factorIndex, FilterType type) noexcept;
+
+private:
+    using Oversampler = HalfBandOversampler<SampleType>;
+
+    Oversampler* get(int factorIndex, FilterType type) const noexcept;
+    static int measureTail(Oversampler& os, int numChannels);
+
+    // [type][facteur - 1]
+    std::array<std::array<std::unique_ptr<Oversampler>, numFactors - 1>, 2> oversamplers;
+    std::array<std::array<int, numFactors - 1>, 2> tailSamples {};
+    Oversampler* active = nullptr;
+    std::vector<SampleType*> channelPointers;   // morceau courant, taille fixée au prepare
+};
@@ -9,35 +9,15 @@
 #include "ImageKnob.h"
 #include "PluginEditor.h"
 #include "PluginProcessor.h"
-#include "BinaryData.h"
 
 static const char* paramIDs[4] = {"LowGain", "MidGain", "HighGain", "MidQ"};
 static const char* paramLabels[4] = {"Low Gain", "Mid Gain", "High Gain", "Mid Q"};
 
-class GainKnobLookAndFeels {
-public:
-    GainKnobLookAndFeels()
-        : blackKnob(juce::ImageFileFormat::loadFrom(BinaryData::blackknob_png, BinaryData::blackknob_pngSize)),
-          pinkKnob(juce::ImageFileFormat::loadFrom(BinaryData::pinkknob_png, BinaryData::pinkknob_pngSize)),
-          whiteKnob(juce::ImageFileFormat::loadFrom(BinaryData::whiteknob_png, BinaryData::whiteknob_pngSize)) {}
-    ImageKnobLookAndFeel blackKnob, pinkKnob, whiteKnob;
-};
-
-// Ajout d'une classe Timer interne pour la popup
-class GainPopupTimer : public juce::Timer {
-public:
-    GainPopupTimer(std::function<void()> cb) : callback(std::move(cb)) {}
-    void timerCallback() override { if (callback) callback(); }
-private:
-    std::function<void()> callback;
-};
-
 // LookAndFeel custom pour le bouton texte DIST
 class DistTextButtonLookAndFeel : public juce::LookAndFeel_V4 {
 public:
-    DistTextButtonLookAndFeel() {
-        distTypeface = juce::Typeface::createSystemTypefaceFor(BinaryData::Metropolitan_ttf, BinaryData::Metropolitan_ttfSize);
-    }
+    explicit DistTextButtonLookAndFeel(juce::Typeface::Ptr typeface)
+        : font(juce::Font(typeface.get()).withPointHeight(40.0f)) {}
     void drawButtonBackground(juce::Graphics& g, juce::Button& button, const juce::Colour&, bool, bool) override {
         // Fond transparent, contour noir
         auto bounds = button.getLocalBounds().toFloat();
@@ -47,7 +27,6 @@ public:
         g.drawRect(bounds, 2.0f);
     }
     void drawButtonText(juce::Graphics& g, juce::TextButton& button, bool isMouseOverButton, bool) override {
-        auto font = juce::Font(distTypeface.get()).withPointHeight(40.0f);
         g.setFont(font);
         auto onColour = juce::Colour::fromRGB(210, 122, 196); // MerjEQ
         auto offColour = juce::Colour::fromRGB(192, 192, 192); // Boomy
@@ -57,37 +36,69 @@ public:
         g.drawFittedText(button.getButtonText(), button.getLocalBounds(), juce::Justification::centred, 1);
     }
 private:
-    juce::Typeface::Ptr distTypeface;
+    juce::Font font;
 };
 
-static DistTextButtonLookAndFeel distTextButtonLF;
+struct MerjEQAudioProcessorEditor::LookAndFeels
+{
+    explicit LookAndFeels(EditorResources& r)
+        : blackKnob(r.getImage(EditorResources::blackKnob), r.getValueTypeface()),
+          pinkKnob(r.getImage(EditorResources::pinkKnob), r.getValueTypeface()),
+          whiteKnob(r.getImage(EditorResources::whiteKnob), r.getValueTypeface()),
+          distText(r.getTitleTypeface()) {}
 
-namespace {
-    std::unique_ptr<GainKnobLookAndFeels> gainKnobLFs;
-}
+    ImageKnobLookAndFeel blackKnob, pinkKnob, whiteKnob;
+    DistTextButtonLookAndFeel distText;
+};
 
 MerjEQAudioProcessorEditor::MerjEQAudioProcessorEditor(MerjEQAudioProcessor& p)
     : AudioProcessorEditor(&p), processor(p)
 {
-    // Fond
-    auto* imgData = BinaryData::backgroundmodern_png;
-    int imgSize = BinaryData::backgroundmodern_pngSize;
-    auto loadedImg = juce::ImageFileFormat::loadFrom(imgData, imgSize);
-    if (loadedImg.isValid())
-        backgroundImage = std::make_unique<juce::Image>(loadedImg);
-    else
-        backgroundImage = nullptr;
-    setSize(1152, 384);
+    const auto openStart = juce::Time::getMillisecondCounterHiRes();
 
-    // Initialiser LookAndFeel pour les sliders de gain
-    if (!gainKnobLFs)
-        gainKnobLFs = std::make_unique<GainKnobLookAndFeels>();
+    // Polices et LookAndFeels depuis le cache partagé (images éventuellement pas encore décodées)
+    lookAndFeels = std::make_unique<LookAndFeels>(*resources);
+    auto typeface = resources->getTitleTypeface();
+    titleFont = juce::Font(typeface.get()).withPointHeight(40.0f);
+    labelFont = juce::Font(typeface.get()).withPointHeight(24.0f);
+    distFont = juce::Font(typeface.get()).withPointHeight(20.0f);
+
+    // Spectre : l'analyse ne tourne que tant qu'un affichage existe
+    spectrumDisplay = std::make_unique<SpectrumDisplay>(processor.analyzer);
+    addAndMakeVisible(*spectrumDisplay);
+    responseCurve = std::make_unique<ResponseCurveDisplay>(processor, processor.apvts);
+    addAndMakeVisible(*responseCurve);
+
+    // Mesures DSP : surcouche masquée, ouverte par un petit bouton dans le coin
+    profilerOverlay = std::make_unique<ProfilerOverlay>(processor.profiler);
+    addChildComponent(*profilerOverlay);
+    profilerButton = std::make_unique<juce::TextButton>("perf");
+    profilerButton->setClickingTogglesState(true);
+    profilerButton->setColour(juce::TextButton::buttonColourId, juce::Colours::transparentBlack);
+    profilerButton->setColour(juce::TextButton::buttonOnColourId, juce::Colour::fromRGB(210, 122, 196).withAlpha(0.4f));
+    profilerButton->onClick = [this]() {
+        profilerOverlay->setVisible(profilerButton->getToggleState());
+    };
+    addAndMakeVisible(*profilerButton);
+
+   #if JucePlugin_Enable_ARA
+    // Suggestion ARA : valeurs en info-bulle, appliquées au clic
+    suggestionButton = std::make_unique<juce::TextButton>("ara");
+    suggestionButton->setColour(juce::TextButton::buttonColourId, juce::Colours::transparentBlack);
+    suggestionButton->onClick = [this]() { processor.applyVocalSuggestion(); };
+    addChildComponent(*suggestionButton);
+    updateSuggestionButton();
+    processor.vocalSuggestionChanged.addChangeListener(this);
+   #endif
+
+    setSize(1152, 384);
 
     // Sliders et attachements
     for (int i = 0; i < 4; ++i)
     {
         sliders[i].setSliderStyle(juce::Slider::RotaryVerticalDrag);
         sliders[i].setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0); // Supprime la boîte de valeur
+        sliders[i].setRepaintsOnMouseActivity(true); // valeur affichée au survol par le LookAndFeel
         this->addAndMakeVisible(sliders[i]);
     }
 
@@ -98,84 +109,24 @@ MerjEQAudioProcessorEditor::MerjEQAudioProcessorEditor(MerjEQAudioProcessor& p)
     sliders[3].setValue(1.0f); // Q à 1 par défaut
 
     // Appliquer LookAndFeel personnalisé pour chaque slider de gain
-    sliders[0].setLookAndFeel(&gainKnobLFs->blackKnob); // Low Gain
-    sliders[1].setLookAndFeel(&gainKnobLFs->pinkKnob);  // Mid Gain
-    sliders[2].setLookAndFeel(&gainKnobLFs->whiteKnob); // High Gain
-    sliders[3].setLookAndFeel(&gainKnobLFs->pinkKnob);  // Mid Q (ImageKnob pink)
-    gainKnobLFs->pinkKnob.setMidQSliderPointer(&sliders[3]);
+    sliders[0].setLookAndFeel(&lookAndFeels->blackKnob); // Low Gain
+    sliders[1].setLookAndFeel(&lookAndFeels->pinkKnob);  // Mid Gain
+    sliders[2].setLookAndFeel(&lookAndFeels->whiteKnob); // High Gain
+    sliders[3].setLookAndFeel(&lookAndFeels->pinkKnob);  // Mid Q (ImageKnob pink)
+    lookAndFeels->pinkKnob.setMidQSliderPointer(&sliders[3]);
 
     // Attachments
     for (int i = 0; i < 4; ++i)
         attachments[i] = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(processor.apvts, paramIDs[i], sliders[i]);
 
-    // Ajout des callbacks pour afficher la valeur du gain ou Q
-    gainPopupSlider = -1;
-    gainPopupText = "";
-    gainPopupTimer.reset();
-
-    for (int i = 0; i < 3; ++i) {
-        sliders[i].onValueChange = [this, i]() {
-            if (sliders[i].isMouseButtonDown()) {
-                gainPopupText = juce::String(sliders[i].getValue(), 1) + " dB";
-                gainPopupSlider = i;
-                if (gainPopupTimer) gainPopupTimer->stopTimer();
-                gainPopupTimer = std::make_unique<GainPopupTimer>([this]() { gainPopupSlider = -1; this->repaint(); });
-                gainPopupTimer->startTimer(1500);
-                this->repaint();
-            }
-        };
-        sliders[i].onDragStart = [this, i]() {
-            gainPopupText = juce::String(sliders[i].getValue(), 1) + " dB";
-            gainPopupSlider = i;
-            if (gainPopupTimer) gainPopupTimer->stopTimer();
-            this->repaint();
-        };
-        sliders[i].onDragEnd = [this]() {
-            if (gainPopupTimer) gainPopupTimer->stopTimer();
-            gainPopupSlider = -1;
-            this->repaint();
-        };
-    }
-
-    sliders[3].onValueChange = [this]() {
-        if (sliders[3].isMouseButtonDown()) {
-            gainPopupText = juce::String(sliders[3].getValue(), 2);
-            gainPopupSlider = 3;
-            if (gainPopupTimer) gainPopupTimer->stopTimer();
-            gainPopupTimer = std::make_unique<GainPopupTimer>([this]() { gainPopupSlider = -1; this->repaint(); });
-            gainPopupTimer->startTimer(1500);
-            this->repaint();
-        }
-    };
-    sliders[3].onDragStart = [this]() {
-        gainPopupText = juce::String(sliders[3].getValue(), 2);
-        gainPopupSlider = 3;
-        if (gainPopupTimer) gainPopupTimer->stopTimer();
-        this->repaint();
-    };
-    sliders[3].onDragEnd = [this]() {
-        if (gainPopupTimer) gainPopupTimer->stopTimer();
-        gainPopupSlider = -1;
-        this->repaint();
-    };
-
     // --- Création du bouton de distorsion avec DrawableButton ---
-    // Chargement des images avec Drawable pour préserver la transparence PNG
-    distOnImage.reset(juce::Drawable::createFromImageData(BinaryData::SaturationON_png, 
-                                                        BinaryData::SaturationON_pngSize).release());
-    distOffImage.reset(juce::Drawable::createFromImageData(BinaryData::SaturationOFF_png, 
-                                                        BinaryData::SaturationOFF_pngSize).release());
-                                                        
-    // Création du DrawableButton avec mode ImageOnButtonBackground
+    // Création du DrawableButton avec mode ImageOnButtonBackground (images posées par applyImages)
     distButton = std::make_unique<juce::DrawableButton>("DistButton", juce::DrawableButton::ImageOnButtonBackground);
-    distButton->setImages(distOffImage.get(), nullptr, nullptr, nullptr,
-                         distOnImage.get(), nullptr, nullptr, nullptr);
-                         
     distButton->setClickingTogglesState(true);
     distButton->setToggleState(false, juce::dontSendNotification);
+    // Le bouton se redessine seul : rien à invalider côté éditeur
     distButton->onClick = [this]() {
         distState = distButton->getToggleState();
-        repaint();
     };
     addAndMakeVisible(*distButton);
 
@@ -187,39 +138,118 @@ MerjEQAudioProcessorEditor::MerjEQAudioProcessorEditor(MerjEQAudioProcessor& p)
     distTextButton->setColour(juce::TextButton::buttonOnColourId, juce::Colours::transparentBlack);
     distTextButton->setClickingTogglesState(true);
     distTextButton->setToggleState(false, juce::dontSendNotification);
-    distTextButton->setLookAndFeel(&distTextButtonLF);
-    distTextButton->onClick = [this]() {
-        repaint();
-    };
+    distTextButton->setLookAndFeel(&lookAndFeels->distText);
     addAndMakeVisible(*distTextButton);
+
+    // Images décodées : tout de suite si le cache est prêt, sinon à la notification
+    applyImages();
+    resources->addChangeListener(this);
+    resources->editorOpened(juce::Time::getMillisecondCounterHiRes() - openStart);
 }
 
 MerjEQAudioProcessorEditor::~MerjEQAudioProcessorEditor()
 {
-    // Important: détacher LookAndFeel pour éviter les fuites
-    for (int i = 0; i < 3; ++i)
-        sliders[i].setLookAndFeel(nullptr);
+   #if JucePlugin_Enable_ARA
+    processor.vocalSuggestionChanged.removeChangeListener(this);
+   #endif
+    resources->removeChangeListener(this);
+    resources->editorClosed();
+
+    // Important: détacher LookAndFeel avant leur destruction
+    for (auto& slider : sliders)
+        slider.setLookAndFeel(nullptr);
+    if (distTextButton)
+        distTextButton->setLookAndFeel(nullptr);
+}
+
+void MerjEQAudioProcessorEditor::changeListenerCallback(juce::ChangeBroadcaster* source)
+{
+   #if JucePlugin_Enable_ARA
+    if (source == &processor.vocalSuggestionChanged) {
+        updateSuggestionButton();
+        return;
+    }
+   #else
+    juce::ignoreUnused(source);
+   #endif
+    applyImages();
+}
+
+#if JucePlugin_Enable_ARA
+void MerjEQAudioProcessorEditor::updateSuggestionButton()
+{
+    const auto s = processor.getVocalSuggestion();
+    suggestionButton->setVisible(s.valid);
+    if (!s.valid)
+        return;
+    auto gain = [](float db) { return (db > 0.0f ? "+" : "") + juce::String(db, 1) + " dB"; };
+    suggestionButton->setTooltip("Vocal analysis (" + juce::String(juce::roundToInt(s.activeSeconds)) + " s, range "
+                                 + juce::String(juce::roundToInt(s.loudnessRangeDb)) + " dB)\n"
+                                 + "Low " + gain(s.eq.lowGain) + ", Mid " + gain(s.eq.midGain)
+                                 + " (Q " + juce::String(s.eq.midQ, 2) + "), High " + gain(s.eq.highGain));
+}
+#endif
+
+void MerjEQAudioProcessorEditor::applyImages()
+{
+    if (!resources->isReady())
+        return;
+
+    // Copies de juce::Image : pixels partagés avec le cache, rien n'est redécodé
+    backgroundImage = resources->getImage(EditorResources::background);
+    lookAndFeels->blackKnob.setKnobImage(resources->getImage(EditorResources::blackKnob));
+    lookAndFeels->pinkKnob.setKnobImage(resources->getImage(EditorResources::pinkKnob));
+    lookAndFeels->whiteKnob.setKnobImage(resources->getImage(EditorResources::whiteKnob));
+
+    // DrawableImage pour préserver la transparence PNG
+    auto makeDrawable = [](const juce::Image& image) {
+        auto drawable = std::make_unique<juce::DrawableImage>();
+        drawable->setImage(image);
+        return drawable;
+    };
+    distOnImage = makeDrawable(resources->getImage(EditorResources::saturationOn));
+    distOffImage = makeDrawable(resources->getImage(EditorResources::saturationOff));
+    distButton->setImages(distOffImage.get(), nullptr, nullptr, nullptr,
+                         distOnImage.get(), nullptr, nullptr, nullptr);
+    staticLayer = {};
+    repaint();
 }
 
 void MerjEQAudioProcessorEditor::paint(juce::Graphics& g)
+{
+    // Couche statique rendue au pixel physique près : simple copie, sans rééchantillonnage
+    const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    if (!staticLayer.isValid() || scale != staticLayerScale)
+        renderStaticLayer(scale);
+
+    g.setImageResamplingQuality(juce::Graphics::lowResamplingQuality);
+    g.drawImage(staticLayer, getLocalBounds().toFloat());
+}
+
+void MerjEQAudioProcessorEditor::renderStaticLayer(float scale)
+{
+    staticLayer = juce::Image(juce::Image::RGB, juce::jmax(1, juce::roundToInt(getWidth() * scale)),
+                              juce::jmax(1, juce::roundToInt(getHeight() * scale)), false);
+    juce::Graphics g(staticLayer);
+    g.addTransform(juce::AffineTransform::scale(scale));
+    paintStaticLayer(g);
+    staticLayerScale = scale;
+}
+
+void MerjEQAudioProcessorEditor::paintStaticLayer(juce::Graphics& g)
 {
     // Affiche le fond
-    if (backgroundImage && backgroundImage->isValid())
-        g.drawImage(*backgroundImage, getLocalBounds().toFloat());
+    if (backgroundImage.isValid())
+        g.drawImage(backgroundImage, getLocalBounds().toFloat());
     else
         g.fillAll(juce::Colours::black);
 
     // Affichage du titre du plugin en haut, centré, police Metropolitan.ttf, rose clair
-    auto typeface = juce::Typeface::createSystemTypefaceFor(BinaryData::Metropolitan_ttf, BinaryData::Metropolitan_ttfSize);
-    juce::Font titleFont(typeface.get());
-    titleFont = titleFont.withPointHeight(40.0f);
     g.setFont(titleFont);
     g.setColour(juce::Colour::fromRGB(210, 122, 196)); // rose clair
     g.drawFittedText("Merj EQ", 0, 10, getWidth(), 40, juce::Justification::centredTop, 1);
 
     // Titres personnalisés au-dessus de chaque knob
-    juce::Font labelFont(typeface.get());
-    labelFont = labelFont.withPointHeight(24.0f); // Taille initiale restaurée
     g.setFont(labelFont);
     g.setColour(juce::Colour::fromRGB(192, 192, 192)); // argenté
     // Low Gain
@@ -234,9 +264,6 @@ void MerjEQAudioProcessorEditor::paint(juce::Graphics& g)
     // --- Affichage du label "Dist" sous le bouton de distorsion ---
     if (distButton) {
         // Label "Dist" sous le bouton, police Metropolitan
-        auto distTypeface = juce::Typeface::createSystemTypefaceFor(BinaryData::Metropolitan_ttf, BinaryData::Metropolitan_ttfSize);
-        juce::Font distFont(distTypeface.get());
-        distFont = distFont.withPointHeight(20.0f);
         g.setFont(distFont);
         g.setColour(juce::Colours::white);
         g.drawFittedText("Dist", distButton->getX(), distButton->getY() + distButton->getHeight() + 5,
@@ -271,10 +298,31 @@ void MerjEQAudioProcessorEditor::resized()
     // Affiche la valeur du Mid Q en info-bulle (tooltip)
     sliders[3].setTooltip("Q: " + juce::String(sliders[3].getValue(), 2));
 
+    // Les libellés suivent les knobs : couche statique à refaire
+    staticLayer = {};
+
     // Positionnement du bouton de distorsion - coordonnées fixes
     if (distButton)
         distButton->setBounds(70, 230, 90, 90);
 
     if (distTextButton)
         distTextButton->setBounds(50, 140, 180, 60); // monté à y=140
+
+    // Spectre et courbe de réponse entre le titre et les libellés, sur la largeur des knobs
+    const juce::Rectangle<int> curveArea(leftPad, 58, sliders[2].getRight() - leftPad, 80);
+    if (spectrumDisplay)
+        spectrumDisplay->setBounds(curveArea);
+    if (responseCurve)
+        responseCurve->setBounds(curveArea);
+
+    if (profilerButton)
+        profilerButton->setBounds(getWidth() - 54, getHeight() - 26, 48, 20);
+   #if JucePlugin_Enable_ARA
+    if (suggestionButton)
+        suggestionButton->setBounds(getWidth() - 108, getHeight() - 26, 48, 20);
+   #endif
+    // En haut à droite, au-dessus des knobs : redessiner la surcouche ne redessine aucun knob
+    // (sinon chaque rafraîchissement compterait un paint de knob et en relancerait un autre)
+    if (profilerOverlay)
+        profilerOverlay->setBounds(getWidth() - 214, 6, 208, 160);
 }
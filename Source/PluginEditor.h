@@ -9,10 +9,15 @@
 #pragma once
 #include <JuceHeader.h>
 #include <array>
+#include "EditorResources.h"
+#include "SpectrumDisplay.h"
+#include "ResponseCurveDisplay.h"
+#include "ProfilerOverlay.h"
 
 class MerjEQAudioProcessor;
 
-class MerjEQAudioProcessorEditor : public juce::AudioProcessorEditor
+class MerjEQAudioProcessorEditor : public juce::AudioProcessorEditor,
+                                   private juce::ChangeListener
 {
 public:
     MerjEQAudioProcessorEditor(MerjEQAudioProcessor&);
@@ -22,13 +27,26 @@ public:
     void resized() override;
 
 private:
+    void changeListenerCallback(juce::ChangeBroadcaster*) override;
+    void applyImages();
+
+    // Couche statique (fond, titre, libellés) rendue une fois à l'échelle d'affichage
+    void renderStaticLayer(float scale);
+    void paintStaticLayer(juce::Graphics& g);
+
     MerjEQAudioProcessor& processor;
-    std::unique_ptr<juce::Image> backgroundImage;
+
+    // Images et polices partagées entre éditeurs ; LookAndFeels propres à cet éditeur
+    juce::SharedResourcePointer<EditorResources> resources;
+    struct LookAndFeels;
+    std::unique_ptr<LookAndFeels> lookAndFeels;
+    juce::Image backgroundImage;
+    juce::Font titleFont, labelFont, distFont;
+    juce::Image staticLayer;
+    float staticLayerScale = 0.0f;
 
     std::array<juce::Slider, 4> sliders;
-    std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>, 4> attachments;    juce::String gainPopupText;
-    int gainPopupSlider = -1;
-    std::unique_ptr<juce::Timer> gainPopupTimer;
+    std::array<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>, 4> attachments;
 
     // Bouton de distorsion avec images custom
     std::unique_ptr<juce::DrawableButton> distButton;
@@ -38,5 +56,22 @@ private:
 
     std::unique_ptr<juce::TextButton> distTextButton;
 
+    // Spectre avant/après EQ au-dessus des knobs, courbe de réponse par-dessus
+    std::unique_ptr<SpectrumDisplay> spectrumDisplay;
+    std::unique_ptr<ResponseCurveDisplay> responseCurve;
+
+    // Mesures DSP de l'instance, masquées par défaut (aucune mesure tant qu'elles le sont)
+    std::unique_ptr<ProfilerOverlay> profilerOverlay;
+    std::unique_ptr<juce::TextButton> profilerButton;
+
+   #if JucePlugin_Enable_ARA
+    // Suggestion ARA (prises de la piste analysées) : bouton visible dès qu'elle existe
+    std::unique_ptr<juce::TextButton> suggestionButton;
+    void updateSuggestionButton();
+   #endif
+
+    // Info-bulles (Mid Q, suggestion ARA) : dans la fenêtre du plugin, l'hôte n'en fournit pas
+    juce::TooltipWindow tooltipWindow { this };
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MerjEQAudioProcessorEditor)
 };
@@ -7,47 +7,88 @@
 */
 
 #include "PluginProcessor.h"
-#include "PluginEditor.h"
+#if ! MERJEQ_HEADLESS
+ #include "PluginEditor.h"
+#endif
+#include "Waveshaper.h"
 
-juce::AudioProcessorValueTreeState::ParameterLayout MerjEQAudioProcessor::createParameterLayout()
+namespace
 {
-    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("LowGain", "Low Gain", juce::NormalisableRange<float>(-12.0f, 12.0f), 0.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("MidGain", "Mid Gain", juce::NormalisableRange<float>(-12.0f, 12.0f), 0.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("HighGain", "High Gain", juce::NormalisableRange<float>(-12.0f, 12.0f), 0.0f));
-    params.push_back(std::make_unique<juce::AudioParameterFloat>("MidQ", "Mid Q", juce::NormalisableRange<float>(0.1f, 5.0f), 1.0f));
-    params.push_back(std::make_unique<juce::AudioParameterBool>("saturationEnabled", "Saturation Enabled", false));
-    return { params.begin(), params.end() };
-}
+    // Seuil « silence » : sous le plus petit float normalisé (les dénormaux sont mis à zéro)
+    constexpr float silenceThreshold = std::numeric_limits<float>::min();
 
-// === Saturation parameters ===
-bool enableSaturation = true; // Activation facile de la saturation
-float saturationInputGain = 1.2f; // Gain d'entrée pour la saturation (ajustable)
-
-// Fonction de saturation harmonique douce (type lampe, harmoniques paires)
-inline float applySaturation(float x)
-{
-    // Gain d'entrée
-    x *= saturationInputGain;
-    // Saturation douce type lampe (tanh + 10% d'asin pour enrichir les paires)
-    float saturated = std::tanh(x) + 0.1f * std::asin(std::clamp(x, -1.0f, 1.0f));
-    // Normalisation douce pour éviter le clipping
-    return juce::jlimit(-1.0f, 1.0f, saturated * 0.9f);
+    template <typename SampleType>
+    bool isSilent(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+    {
+        if (buffer.hasBeenCleared())
+            return true;
+        for (int ch = 0; ch < numChannels; ++ch)
+            if (buffer.getMagnitude(ch, 0, buffer.getNumSamples()) >= (SampleType) silenceThreshold)
+                return false;
+        return true;
+    }
 }
 
-// Fonction de saturation douce (tanh, +6 dB drive)
-inline float softSaturation(float x)
+juce::AudioProcessorValueTreeState::ParameterLayout MerjEQAudioProcessor::createParameterLayout()
 {
-    return std::tanh(x * 2.0f);
+    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+    const juce::NormalisableRange<float> gainRange(EQBands::minGainDb, EQBands::maxGainDb);
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("LowGain", "Low Gain", gainRange, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("MidGain", "Mid Gain", gainRange, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("HighGain", "High Gain", gainRange, 0.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("MidQ", "Mid Q", juce::NormalisableRange<float>(EQBands::minQ, EQBands::maxQ), 1.0f));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("saturationEnabled", "Saturation Enabled", false));
+    // Qualité du tanh : Exact (libm), High (rationnelle 7/6, erreur <= 1e-4), Fast (3/2, <= 2.4e-2)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("SaturationQuality", "Saturation Quality", juce::StringArray{ "Exact", "High", "Fast" }, 1));
+    // Suréchantillonnage autour de la saturation (anti-repliement des harmoniques)
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("OversamplingFactor", "Oversampling", juce::StringArray{ "1x", "2x", "4x", "8x" }, 0));
+    // Phase linéaire : même amplitude que les 3 sections, sans rotation de phase (latence ~50 ms)
+    params.push_back(std::make_unique<juce::AudioParameterBool>("linearPhase", "Linear Phase", false));
+    params.push_back(std::make_unique<juce::AudioParameterChoice>("OversamplingFilter", "Oversampling Filter", juce::StringArray{ "Min-phase IIR", "Linear-phase FIR" }, 0));
+    // Mode dynamique par bande : le gain n'est appliqué que lorsque la bande dépasse son seuil
+    params.push_back(std::make_unique<juce::AudioParameterBool>("LowDynamic", "Low Dynamic", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("MidDynamic", "Mid Dynamic", false));
+    params.push_back(std::make_unique<juce::AudioParameterBool>("HighDynamic", "High Dynamic", false));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("LowThreshold", "Low Threshold", juce::NormalisableRange<float>(-60.0f, 0.0f), -30.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("MidThreshold", "Mid Threshold", juce::NormalisableRange<float>(-60.0f, 0.0f), -30.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("HighThreshold", "High Threshold", juce::NormalisableRange<float>(-60.0f, 0.0f), -30.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("DynamicAttack", "Dynamic Attack", juce::NormalisableRange<float>(0.1f, 50.0f), 2.0f));
+    params.push_back(std::make_unique<juce::AudioParameterFloat>("DynamicRelease", "Dynamic Release", juce::NormalisableRange<float>(5.0f, 500.0f), 60.0f));
+    return { params.begin(), params.end() };
 }
 
 MerjEQAudioProcessor::MerjEQAudioProcessor()
-    : apvts(*this, nullptr, "Parameters", createParameterLayout())
+    : AudioProcessor(BusesProperties().withInput("Input", juce::AudioChannelSet::stereo(), true)
+                                      .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+      apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Force gain params to 0.0 dB at construction (centered)
     if (auto* low = apvts.getParameter("LowGain")) low->setValueNotifyingHost(0.5f);
     if (auto* mid = apvts.getParameter("MidGain")) mid->setValueNotifyingHost(0.5f);
     if (auto* high = apvts.getParameter("HighGain")) high->setValueNotifyingHost(0.5f);
+
+    saturationParam = apvts.getRawParameterValue("saturationEnabled");
+    saturationQualityParam = apvts.getRawParameterValue("SaturationQuality");
+    oversamplingFactorParam = apvts.getRawParameterValue("OversamplingFactor");
+    oversamplingFilterParam = apvts.getRawParameterValue("OversamplingFilter");
+    linearPhaseParam = apvts.getRawParameterValue("linearPhase");
+    dynamicParams = { apvts.getRawParameterValue("LowDynamic"), apvts.getRawParameterValue("MidDynamic"), apvts.getRawParameterValue("HighDynamic") };
+    thresholdParams = { apvts.getRawParameterValue("LowThreshold"), apvts.getRawParameterValue("MidThreshold"), apvts.getRawParameterValue("HighThreshold") };
+    dynamicAttackParam = apvts.getRawParameterValue("DynamicAttack");
+    dynamicReleaseParam = apvts.getRawParameterValue("DynamicRelease");
+
+    // Les filtres JUCE démarrent en 1er ordre : on leur donne un biquad neutre une fois
+    // pour toutes, ensuite les coefficients sont mis à jour sur place
+    lowShelfCoefficients = new juce::dsp::IIR::Coefficients<float>(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+    midBandCoefficients = new juce::dsp::IIR::Coefficients<float>(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+    highShelfCoefficients = new juce::dsp::IIR::Coefficients<float>(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f);
+
+    eqTailSamples = EQDesign::worstCaseTailSamples(lastSampleRate, silenceThreshold);
+    profileDumper = ProfileDumper::createFromCommandLine(profiler);
+
+   #if JucePlugin_Enable_ARA
+    startTimerHz(4);
+   #endif
 }
 
 MerjEQAudioProcessor::~MerjEQAudioProcessor() = default;
@@ -55,119 +96,576 @@ MerjEQAudioProcessor::~MerjEQAudioProcessor() = default;
 void MerjEQAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     lastSampleRate = sampleRate;
+    const int numChannels = juce::jmax(1, getTotalNumOutputChannels());
+
+    // Tout l'état par canal est (re)dimensionné ici, jamais dans processBlock
+    auto prepareBand = [numChannels](std::vector<juce::dsp::IIR::Filter<float>>& filters,
+                                     const juce::dsp::IIR::Coefficients<float>::Ptr& coefficients) {
+        filters.clear();
+        for (int ch = 0; ch < numChannels; ++ch)
+            filters.emplace_back(coefficients);
+    };
+    prepareBand(lowShelfFilter, lowShelfCoefficients);
+    prepareBand(midBandFilter, midBandCoefficients);
+    prepareBand(highShelfFilter, highShelfCoefficients);
+
     juce::dsp::ProcessSpec spec{ sampleRate, static_cast<juce::uint32>(samplesPerBlock), 1 };
-    for (int ch = 0; ch < 2; ++ch) {
+    for (int ch = 0; ch < numChannels; ++ch) {
+        lowShelfFilter[(size_t) ch].prepare(spec);
+        midBandFilter[(size_t) ch].prepare(spec);
+        highShelfFilter[(size_t) ch].prepare(spec);
+    }
+    // La précision et le mode offline sont fixés par l'hôte avant prepareToPlay.
+    // Coefficients double conçus seulement si l'hôte traite en double
+    const bool doublePrecision = isUsingDoublePrecision();
+    activeEngine = selectedEngine();
+    coefficientUpdater.prepare(sampleRate, activeCoefficients, doublePrecision);
+
+    // Offline : une partition de canaux par worker en plus du thread de rendu
+    const int maxPartitions = isNonRealtime() ? workers.getObject().getNumWorkers() + 1 : 1;
+    if (doublePrecision)
+        prepareState(doubleState, sampleRate, numChannels, samplesPerBlock, maxPartitions);
+    else
+        prepareState(floatState, sampleRate, numChannels, samplesPerBlock, maxPartitions);
+    conversionBuffer.setSize(doublePrecision ? numChannels : 0, doublePrecision ? juce::jmax(1, samplesPerBlock) : 0);
+   #if JucePlugin_Enable_ARA
+    prepareToPlayForARA(sampleRate, samplesPerBlock, numChannels, getProcessingPrecision());
+    araRenderBuffer.setSize(doublePrecision ? numChannels : 0, doublePrecision ? juce::jmax(1, samplesPerBlock) : 0);
+   #endif
+    applyCoefficients();
+    linearPhaseEQ.prepare(sampleRate, numChannels);
+    analyzer.prepare(sampleRate);
+    presets.prepare(sampleRate);
+    eqTailSamples = EQDesign::worstCaseTailSamples(sampleRate, silenceThreshold);
+    silentSamples = 0;
+    reportedLatency = saturatorLatencySamples() + engineLatencySamples(activeEngine);
+    setLatencySamples(reportedLatency);
+}
+
+template <typename SampleType>
+void MerjEQAudioProcessor::prepareState(PrecisionState<SampleType>& state, double sampleRate, int numChannels,
+                                        int samplesPerBlock, int maxPartitions)
+{
+    // Coefficients de la cascade : ceux du CoefficientUpdater (tables partagées, tâche de fond)
+    state.core.setParameters(coreParameters(activeEngine));
+    state.core.setCoefficients(activeCoefficients);
+    state.core.prepare(sampleRate, numChannels, samplesPerBlock, maxPartitions);
+    state.core.resetBypass(isEQNeutral(activeEngine, state));
+
+    // Saturation découpée comme le moteur
+    state.saturators.resize((size_t) state.core.getNumPartitions());
+    for (int p = 0; p < state.core.getNumPartitions(); ++p)
+        state.saturators[(size_t) p].prepare(state.core.getPartition(p).numChannels, samplesPerBlock);
+}
+
+void MerjEQAudioProcessor::handleAsyncUpdate()
+{
+    // Changement de facteur de suréchantillonnage : l'hôte est prévenu depuis le thread de message
+    setLatencySamples(reportedLatency.load());
+    applyPendingProgram();
+}
+
+void MerjEQAudioProcessor::updateFilters()
+{
+    // Rendu offline : conception immédiate pour rester calé sur l'automation,
+    // sinon on récupère le dernier jeu publié par le thread de conception.
+    const bool changed = isNonRealtime() ? coefficientUpdater.designPending(activeCoefficients, requiredGeneration)
+                                         : coefficientUpdater.pullLatest(activeCoefficients, requiredGeneration);
+    if (changed) {
+        applyCoefficients();
+        profiler.countCoefficientUpdate();
+    }
+}
+
+void MerjEQAudioProcessor::applyCoefficients()
+{
+    // Écriture directe dans les coefficients existants : pas d'allocation
+    auto setRaw = [](juce::dsp::IIR::Coefficients<float>& coefficients, const BiquadCoefficients& c) {
+        auto* raw = coefficients.getRawCoefficients();
+        raw[0] = c.b0; raw[1] = c.b1; raw[2] = c.b2; raw[3] = c.a1; raw[4] = c.a2;
+    };
+
+    const auto& bands = activeCoefficients.bands;
+    setRaw(*lowShelfCoefficients, bands[EQBands::low]);
+    setRaw(*midBandCoefficients, bands[EQBands::mid]);
+    setRaw(*highShelfCoefficients, bands[EQBands::high]);
+    floatState.core.setCoefficients(activeCoefficients);
+    doubleState.core.setCoefficients(activeCoefficients);
+}
+
+void MerjEQAudioProcessor::resetFilters()
+{
+    floatState.core.reset();
+    doubleState.core.reset();
+    linearPhaseEQ.reset();
+    for (size_t ch = 0; ch < lowShelfFilter.size(); ++ch) {
         lowShelfFilter[ch].reset();
         midBandFilter[ch].reset();
         highShelfFilter[ch].reset();
-        lowShelfFilter[ch].prepare(spec);
-        midBandFilter[ch].prepare(spec);
-        highShelfFilter[ch].prepare(spec);
     }
-    updateFilters();
 }
 
-void MerjEQAudioProcessor::updateFilters()
+template <typename SampleType>
+bool MerjEQAudioProcessor::isEQNeutral(FilterEngine engine, const PrecisionState<SampleType>& state) const noexcept
 {
-    static float prevLowGain = 0.0f, prevMidGain = 0.0f, prevHighGain = 0.0f;
-    static float prevMidQ = 1.0f;
-
-    float LowGain = apvts.getRawParameterValue("LowGain")->load();
-    float MidGain = apvts.getRawParameterValue("MidGain")->load();
-    float HighGain = apvts.getRawParameterValue("HighGain")->load();
-    float MidQ = apvts.getRawParameterValue("MidQ")->load();
+    // Phase linéaire : le signal sec n'aurait pas la latence annoncée, jamais contourné
+    if (engine == FilterEngine::linearPhase)
+        return false;
+    // Filtres JUCE d'origine : mêmes coefficients que la cascade du moteur
+    return state.core.isNeutral();
+}
 
-    bool lowChanged = (LowGain != prevLowGain);
-    bool midChanged = (MidGain != prevMidGain) || (MidQ != prevMidQ);
-    bool highChanged = (HighGain != prevHighGain);
+MerjEQAudioProcessor::FilterEngine MerjEQAudioProcessor::selectedEngine() const noexcept
+{
+    // Les paramètres utilisateur priment sur le choix A/B des outils. Une bande dynamique
+    // l'emporte sur la phase linéaire, dont les noyaux FIR ne suivent pas un gain modulé.
+    for (auto* p : dynamicParams)
+        if (p->load() > 0.5f)
+            return FilterEngine::dynamic;
+    return linearPhaseParam->load() > 0.5f ? FilterEngine::linearPhase : filterEngine.load();
+}
 
-    if (lowChanged) {
-        auto lowCoeffs = juce::dsp::IIR::Coefficients<float>::makeLowShelf(lastSampleRate, 200.0f, 0.707f, juce::Decibels::decibelsToGain(LowGain));
-        for (int ch = 0; ch < 2; ++ch)
-            *lowShelfFilter[ch].coefficients = *lowCoeffs;
-        prevLowGain = LowGain;
+DynamicEQSettings MerjEQAudioProcessor::dynamicSettings() const noexcept
+{
+    DynamicEQSettings s;
+    for (size_t b = 0; b < (size_t) EQBands::numBands; ++b) {
+        s.enabled[b] = dynamicParams[b]->load() > 0.5f;
+        s.thresholdDb[b] = thresholdParams[b]->load();
     }
-    if (midChanged) {
-        auto midCoeffs = juce::dsp::IIR::Coefficients<float>::makePeakFilter(lastSampleRate, 4000.0f, MidQ, juce::Decibels::decibelsToGain(MidGain));
-        for (int ch = 0; ch < 2; ++ch)
-            *midBandFilter[ch].coefficients = *midCoeffs;
-        prevMidGain = MidGain;
-        prevMidQ = MidQ;
+    s.attackMs = dynamicAttackParam->load();
+    s.releaseMs = dynamicReleaseParam->load();
+    return s;
+}
+
+MerjEQCoreParameters MerjEQAudioProcessor::coreParameters(FilterEngine engine) const noexcept
+{
+    // Filtres JUCE d'origine et phase linéaire sont traités ici : le moteur garde sa cascade,
+    // dont les coefficients servent aussi au test de neutralité
+    MerjEQCoreParameters p;
+    p.eq = coefficientUpdater.getParameters();
+    p.engine = engine == FilterEngine::stateVariable ? MerjEQCoreParameters::Engine::stateVariable
+             : engine == FilterEngine::dynamic       ? MerjEQCoreParameters::Engine::dynamic
+                                                     : MerjEQCoreParameters::Engine::fusedCascade;
+    p.dynamics = dynamicSettings();
+    p.saturationEnabled = saturationParam->load() > 0.5f;
+    p.saturationQuality = static_cast<Waveshaper::Quality>((int) saturationQualityParam->load());
+    return p;
+}
+
+int MerjEQAudioProcessor::engineLatencySamples(FilterEngine engine) const noexcept
+{
+    return engine == FilterEngine::linearPhase ? linearPhaseEQ.getLatencySamples() : 0;
+}
+
+int MerjEQAudioProcessor::engineTailSamples(FilterEngine engine) const noexcept
+{
+    return engine == FilterEngine::linearPhase ? linearPhaseEQ.getTailSamples() : eqTailSamples.load();
+}
+
+int MerjEQAudioProcessor::saturatorLatencySamples() const noexcept
+{
+    const int factorIndex = (int) oversamplingFactorParam->load();
+    const auto filterType = static_cast<OversampledSaturatorBase::FilterType>((int) oversamplingFilterParam->load());
+    return isUsingDoublePrecision() ? doubleState.saturators.front().getLatencySamples(factorIndex, filterType)
+                                    : floatState.saturators.front().getLatencySamples(factorIndex, filterType);
+}
+
+int MerjEQAudioProcessor::saturatorTailSamples() const noexcept
+{
+    const int factorIndex = (int) oversamplingFactorParam->load();
+    const auto filterType = static_cast<OversampledSaturatorBase::FilterType>((int) oversamplingFilterParam->load());
+    return isUsingDoublePrecision() ? doubleState.saturators.front().getTailSamples(factorIndex, filterType)
+                                    : floatState.saturators.front().getTailSamples(factorIndex, filterType);
+}
+
+template <typename SampleType>
+void MerjEQAudioProcessor::processEQ(PrecisionState<SampleType>& state, SampleType* const* channels,
+                                     int numChannels, int numSamples) noexcept
+{
+    const auto engine = activeEngine;
+
+    if constexpr (std::is_same_v<SampleType, double>) {
+        // Filtres JUCE d'origine et convolution FFT n'existent qu'en float : aller-retour par conversionBuffer
+        if (engine == FilterEngine::legacyIIR || engine == FilterEngine::linearPhase) {
+            for (int pos = 0; pos < numSamples;) {
+                const int n = juce::jmin(numSamples - pos, conversionBuffer.getNumSamples());
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    const auto* src = channels[ch] + pos;
+                    auto* dst = conversionBuffer.getWritePointer(ch);
+                    for (int i = 0; i < n; ++i)
+                        dst[i] = (float) src[i];
+                }
+                processEQ(floatState, conversionBuffer.getArrayOfWritePointers(), numChannels, n);
+                for (int ch = 0; ch < numChannels; ++ch) {
+                    const auto* src = conversionBuffer.getReadPointer(ch);
+                    auto* dst = channels[ch] + pos;
+                    for (int i = 0; i < n; ++i)
+                        dst[i] = (double) src[i];
+                }
+                pos += n;
+            }
+            return;
+        }
+    } else if (engine == FilterEngine::legacyIIR) {
+        // Une passe par bande : chaque bande a son propre chrono
+        auto block = juce::dsp::AudioBlock<float>(channels, (size_t) numChannels, (size_t) numSamples);
+        auto processBand = [&](std::vector<juce::dsp::IIR::Filter<float>>& filters, DSPProfiler::Stage stage) {
+            const auto t = profiler.start();
+            for (int ch = 0; ch < numChannels; ++ch) {
+                auto channelBlock = block.getSingleChannelBlock((size_t) ch);
+                juce::dsp::ProcessContextReplacing<float> context(channelBlock);
+                filters[(size_t) ch].process(context);
+            }
+            profiler.stop(stage, t);
+        };
+        processBand(lowShelfFilter, DSPProfiler::lowBand);
+        processBand(midBandFilter, DSPProfiler::midBand);
+        processBand(highShelfFilter, DSPProfiler::highBand);
+        return;
     }
-    if (highChanged) {
-        auto highCoeffs = juce::dsp::IIR::Coefficients<float>::makeHighShelf(lastSampleRate, 12000.0f, 0.707f, juce::Decibels::decibelsToGain(HighGain));
-        for (int ch = 0; ch < 2; ++ch)
-            *highShelfFilter[ch].coefficients = *highCoeffs;
-        prevHighGain = HighGain;
+
+    const auto t = profiler.start();
+    if constexpr (std::is_same_v<SampleType, float>) {
+        if (engine == FilterEngine::linearPhase) {
+            linearPhaseEQ.process(channels, numChannels, numSamples);
+            profiler.stop(DSPProfiler::eqPass, t);
+            return;
+        }
     }
+
+    // Cascade fusionnée (avec fondu de preset), SVF ou dynamique : moteur sans JUCE
+    state.core.processEQ(channels, numChannels, numSamples);
+    profiler.stop(DSPProfiler::eqPass, t);
+}
+
+template <typename SampleType>
+void MerjEQAudioProcessor::startProgramFade(PrecisionState<SampleType>& state, int program) noexcept
+{
+    // Seule la cascade fusionnée saute d'un jeu à l'autre (fondu croisé dans le moteur) : le SVF et
+    // le mode dynamique lissent leurs paramètres et la phase linéaire fond déjà ses noyaux
+    activeCoefficients = presets.getCoefficients(program);
+    state.core.setCoefficients(activeCoefficients, activeEngine == FilterEngine::fusedCascade);
+    applyCoefficients();
+}
+
+void MerjEQAudioProcessor::releaseResources()
+{
+   #if JucePlugin_Enable_ARA
+    releaseResourcesForARA();
+   #endif
+}
+
+bool MerjEQAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    // Traitement identique sur chaque canal : n'importe quel format tant que l'entrée égale la sortie
+    const auto& output = layouts.getMainOutputChannelSet();
+    return !output.isDisabled()
+        && output.size() <= maxChannels
+        && output == layouts.getMainInputChannelSet();
 }
 
-void MerjEQAudioProcessor::releaseResources() {}
+bool MerjEQAudioProcessor::supportsDoublePrecisionProcessing() const { return true; }
 
 void MerjEQAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
+{
+   #if JucePlugin_Enable_ARA
+    // Rendu ARA : les régions de la piste remplacent l'entrée, l'EQ suit
+    if (isPlaybackRenderer())
+        processBlockForARA(buffer, isRealtime(), getPlayHead());
+   #endif
+    processSamples(buffer, floatState);
+}
+
+void MerjEQAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&)
+{
+   #if JucePlugin_Enable_ARA
+    // Lecteurs ARA en float : rendu dans araRenderBuffer, puis converti. Taille reprise du bloc
+    // à chaque appel (le rendu attend tous les canaux préparés) ; la capacité réservée au
+    // prepareToPlay évite toute réallocation
+    if (isPlaybackRenderer()) {
+        araRenderBuffer.setSize(buffer.getNumChannels(), buffer.getNumSamples(), false, false, true);
+        processBlockForARA(araRenderBuffer, isRealtime(), getPlayHead());
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
+            const auto* src = araRenderBuffer.getReadPointer(ch);
+            auto* dst = buffer.getWritePointer(ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                dst[i] = (double) src[i];
+        }
+    }
+   #endif
+    processSamples(buffer, doubleState);
+}
+
+template <typename SampleType>
+void MerjEQAudioProcessor::processSamples(juce::AudioBuffer<SampleType>& buffer, PrecisionState<SampleType>& state) noexcept
 {
     juce::ScopedNoDenormals noDenormals;
+    const DSPProfiler::ScopedBlock profiledBlock(profiler, buffer.getNumSamples(), lastSampleRate);
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    // Changement de preset : coefficients précalculés tout de suite ; les jeux conçus
+    // pour les anciens paramètres sont ignorés jusqu'à ce que ceux du preset soient appliqués
+    // (programRequests est incrémenté avant pendingProgram : le numéro lu couvre ce preset)
+    if (const int program = pendingProgram.exchange(-1); program >= 0) {
+        requiredGeneration = programRequests.load();
+        startProgramFade(state, program);
+    }
+    const auto filtersStart = profiler.start();
     updateFilters();
+    profiler.stop(DSPProfiler::updateFilters, filtersStart);
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-        auto channelBlock = block.getSingleChannelBlock(ch);
-        juce::dsp::ProcessContextReplacing<float> context(channelBlock);
-        lowShelfFilter[ch].process(context);
-        midBandFilter[ch].process(context);
-        highShelfFilter[ch].process(context);
+    // Changement de moteur : on repart d'un état propre pour éviter de réutiliser un état périmé
+    const auto parametersStart = profiler.start();
+    const auto engine = selectedEngine();
+    if (engine != activeEngine) {
+        resetFilters();
+        activeEngine = engine;
     }
 
-    // === Saturation douce sur la sortie si activée ===
-    if (apvts.getRawParameterValue("saturationEnabled")->load() > 0.5f) {
-        for (int ch = 0; ch < buffer.getNumChannels(); ++ch) {
-            float* data = buffer.getWritePointer(ch);
-            for (int i = 0; i < buffer.getNumSamples(); ++i) {
-                data[i] = softSaturation(data[i]);
-            }
-        }
+    // Noyaux phase linéaire conçus en tâche de fond, ou tout de suite en rendu offline
+    linearPhaseEQ.setActive(engine == FilterEngine::linearPhase);
+    if (engine == FilterEngine::linearPhase && isNonRealtime())
+        linearPhaseEQ.designPending();
+
+    // Canaux préparés uniquement (l'hôte ne doit pas en envoyer plus)
+    const int numChannels = juce::jmin(buffer.getNumChannels(), (int) lowShelfFilter.size());
+    jassert(numChannels == buffer.getNumChannels());
+    const int numSamples = buffer.getNumSamples();
+
+    // Le SVF et le mode dynamique lissent eux-mêmes les paramètres : lecture directe des valeurs cibles
+    const auto params = coreParameters(engine);
+    state.core.setParameters(params);
+
+    // Rendu offline : partitions de canaux sur les workers, sinon à la suite (même résultat).
+    // Les filtres JUCE d'origine et la phase linéaire restent sur le thread de rendu.
+    auto* pool = isNonRealtime() ? &workers.getObject() : nullptr;
+    state.core.setWorkerPool(pool);
+
+    const bool saturate = params.saturationEnabled;
+    const auto quality = params.saturationQuality;
+    const int factorIndex = (int) oversamplingFactorParam->load();
+    const auto filterType = static_cast<OversampledSaturatorBase::FilterType>((int) oversamplingFilterParam->load());
+    auto& saturators = state.saturators;
+
+    const int latency = saturators.front().getLatencySamples(factorIndex, filterType) + engineLatencySamples(engine);
+    if (latency != reportedLatency.load()) {
+        reportedLatency.store(latency);
+        triggerAsyncUpdate();
+    }
+    profiler.stop(DSPProfiler::parameters, parametersStart);
+
+    // Entrée silencieuse : une fois la traîne écoulée, l'état interne est sous le seuil
+    // des dénormaux et la sortie reste nulle, il n'y a plus rien à calculer
+    const int tailSamples = engineTailSamples(engine) + saturators.front().getTailSamples(factorIndex, filterType);
+    if (isSilent(buffer, numChannels)) {
+        if (silentSamples >= tailSamples)
+            return;
+        silentSamples += numSamples;
+    } else {
+        silentSamples = 0;
+    }
+
+    analyzer.pushPre(buffer, numChannels);
+
+    // EQ neutre (0 dB partout) : buffer laissé intact, avec un fondu quand les paramètres
+    // quittent ou rejoignent le neutre (géré par le moteur, autour de n'importe quel moteur d'EQ)
+    auto& channelPointers = state.channelPointers;
+    for (int ch = 0; ch < numChannels; ++ch)
+        channelPointers[(size_t) ch] = buffer.getWritePointer(ch);
+
+    const bool bypassReached = state.core.processWithBypass(channelPointers.data(), numChannels, numSamples, isEQNeutral(engine, state),
+                                                            [&](SampleType* const* channels, int count, int length) {
+                                                                processEQ(state, channels, count, length);
+                                                            });
+    // Contournement atteint : l'état repart de zéro au prochain fondu entrant
+    if (bypassReached)
+        resetFilters();
+
+    // === Saturation douce sur la sortie si activée (tanh, +6 dB drive, noyaux SIMD, suréchantillonnée) ===
+    auto outputBlock = juce::dsp::AudioBlock<SampleType>(buffer);
+    const auto saturationStart = profiler.start();
+    WorkStealingPool::forEach(pool, (int) saturators.size(), [&](int p) {
+        const auto range = state.core.getPartition(p);
+        const int count = juce::jmin(range.numChannels, numChannels - range.firstChannel);
+        if (count <= 0)
+            return;
+        auto partitionBlock = outputBlock.getSubsetChannelBlock((size_t) range.firstChannel, (size_t) count);
+        saturators[(size_t) p].process(partitionBlock, saturate, quality, factorIndex, filterType);
+    });
+    profiler.stop(DSPProfiler::saturation, saturationStart);
+    analyzer.pushPost(buffer, numChannels);
+
+    // Traîne écoulée sur ce bloc : on remet l'état exactement à zéro avant de suspendre le traitement
+    if (silentSamples >= tailSamples) {
+        resetFilters();
+        for (auto& saturator : saturators)
+            saturator.reset();
     }
 }
 
-juce::AudioProcessorEditor* MerjEQAudioProcessor::createEditor() { return new MerjEQAudioProcessorEditor(*this); }
-bool MerjEQAudioProcessor::hasEditor() const { return true; }
+juce::AudioProcessorEditor* MerjEQAudioProcessor::createEditor()
+{
+   #if MERJEQ_HEADLESS
+    return nullptr;
+   #else
+    return new MerjEQAudioProcessorEditor(*this);
+   #endif
+}
+bool MerjEQAudioProcessor::hasEditor() const { return ! MERJEQ_HEADLESS; }
 
 const juce::String MerjEQAudioProcessor::getName() const { return JucePlugin_Name; }
 bool MerjEQAudioProcessor::acceptsMidi() const { return false; }
 bool MerjEQAudioProcessor::producesMidi() const { return false; }
 bool MerjEQAudioProcessor::isMidiEffect() const { return false; }
-double MerjEQAudioProcessor::getTailLengthSeconds() const { return 0.0; }
+double MerjEQAudioProcessor::getTailLengthSeconds() const
+{
+    // Temps pour que l'EQ puis les filtres de suréchantillonnage retombent sous le seuil des dénormaux
+    const int tail = engineTailSamples(selectedEngine()) + saturatorTailSamples();
+    return tail / lastSampleRate;
+}
 
-int MerjEQAudioProcessor::getNumPrograms() { return 1; }
-int MerjEQAudioProcessor::getCurrentProgram() { return 0; }
-void MerjEQAudioProcessor::setCurrentProgram(int) {}
-const juce::String MerjEQAudioProcessor::getProgramName(int) { return {}; }
+int MerjEQAudioProcessor::getNumPrograms() { return presets.size(); }
+int MerjEQAudioProcessor::getCurrentProgram() { return currentProgram.load(); }
+
+void MerjEQAudioProcessor::setCurrentProgram(int index)
+{
+    // Peut venir du thread audio (automation du programme) : rien d'autre que des atomiques ici
+    if (!juce::isPositiveAndBelow(index, presets.size()))
+        return;
+    currentProgram = index;
+    programRequests.fetch_add(1);
+    programToApply = index;
+    pendingProgram = index;
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        applyPendingProgram();
+    else
+        triggerAsyncUpdate();
+}
+
+void MerjEQAudioProcessor::applyPendingProgram()
+{
+    // Thread de message : les paramètres rejoignent le preset déjà entendu. Le numéro est lu
+    // avant le programme : une demande arrivée entre les deux sera marquée au prochain appel
+    const int request = programRequests.load();
+    if (const int program = programToApply.exchange(-1); program >= 0)
+        applyParameterValues(presets.getPreset(program).values, false);
+    coefficientUpdater.setGeneration(request);
+}
+
+const juce::String MerjEQAudioProcessor::getProgramName(int index)
+{
+    return juce::isPositiveAndBelow(index, presets.size()) ? presets.getPreset(index).name : juce::String();
+}
+
+// Bibliothèque projetée en lecture seule : pas de renommage depuis l'hôte
 void MerjEQAudioProcessor::changeProgramName(const int, const juce::String&) {}
 
 void MerjEQAudioProcessor::getStateInformation(juce::MemoryBlock& destData) {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    PluginState::write(*this, destData);
 }
 void MerjEQAudioProcessor::setStateInformation(const void* data, int sizeInBytes) {
-    std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
-    if (xmlState && xmlState->hasTagName(apvts.state.getType())) {
-        apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+    juce::Array<ParameterValue> values;
+    if (PluginState::read(data, sizeInBytes, values))
+        applyParameterValues(values, true);
+   #if JucePlugin_Enable_ARA
+    // Réglages de la session : pas de suggestion appliquée par-dessus
+    vocalSuggestionApplied = true;
+   #endif
+}
+
+void MerjEQAudioProcessor::applyParameterValues(const juce::Array<ParameterValue>& values, bool resetMissing)
+{
+    // Tous les paramètres d'un coup, sans passer par le ValueTree : seuls ceux qui changent
+    // notifient, et les coefficients sont conçus une seule fois à la fin.
+    // Un paramètre absent revient à sa valeur par défaut (resetMissing) ou n'est pas touché :
+    // rappeler un preset ne coupe ni le suréchantillonnage ni le moteur choisis.
+    // setValueNotifyingHost reste nécessaire pour chaque paramètre modifié : nos paramètres sont
+    // des AudioParameterFloat/Choice/Bool, dont setValue() seul ne prévient pas l'APVTS (valeurs
+    // brutes lues par le thread audio, listener du CoefficientUpdater). C'est aussi ce que fait
+    // replaceState() ; la notification est limitée aux paramètres qui changent vraiment.
+    const CoefficientUpdater::ScopedBulkUpdate bulk(coefficientUpdater);
+    for (auto* p : getParameters()) {
+        auto* param = dynamic_cast<juce::RangedAudioParameter*>(p);
+        if (param == nullptr)
+            continue;
+
+        float normalised = resetMissing ? param->getDefaultValue() : param->getValue();
+        for (auto& v : values)
+            if (v.id == param->getParameterID()) {
+                normalised = param->convertTo0to1(v.value);
+                break;
+            }
+        if (normalised != param->getValue())
+            param->setValueNotifyingHost(normalised);
     }
-    // Always force gain params to 0.0 dB if not present in state
-    if (!apvts.state.hasProperty("LowGain"))
-        apvts.getParameter("LowGain")->setValueNotifyingHost(0.5f);
-    if (!apvts.state.hasProperty("MidGain"))
-        apvts.getParameter("MidGain")->setValueNotifyingHost(0.5f);
-    if (!apvts.state.hasProperty("HighGain"))
-        apvts.getParameter("HighGain")->setValueNotifyingHost(0.5f);
 }
 
+#if JucePlugin_Enable_ARA
+void MerjEQAudioProcessor::timerCallback()
+{
+    if (!isBoundToARA())
+        return;
+
+    // Prises lues par cette instance (rendu et édition), chacune une fois
+    std::vector<VocalAudioSource*> sources;
+    auto collect = [&sources](auto* renderer) {
+        if (renderer == nullptr)
+            return;
+        for (auto* region : renderer->getPlaybackRegions()) {
+            auto* source = region->getAudioModification()->getAudioSource<VocalAudioSource>();
+            if (std::find(sources.begin(), sources.end(), source) == sources.end())
+                sources.push_back(source);
+        }
+    };
+    collect(getPlaybackRenderer());
+    collect(getEditorRenderer());
+
+    VocalProfile merged, profile;
+    for (auto* source : sources)
+        if (source->getProfile(profile))
+            merged.add(profile);
+
+    const auto suggestion = VocalAnalyser::suggest(merged);
+    if (suggestion == vocalSuggestion)
+        return;
+    vocalSuggestion = suggestion;
+
+    // Instance neuve encore aux réglages par défaut : la suggestion devient le point de départ
+    auto isDefault = [this](const char* id) {
+        auto* param = apvts.getParameter(id);
+        return param != nullptr && param->getValue() == param->getDefaultValue();
+    };
+    if (vocalSuggestion.valid && !vocalSuggestionApplied.exchange(true)
+        && isDefault("LowGain") && isDefault("MidGain") && isDefault("HighGain") && isDefault("MidQ"))
+        applyVocalSuggestion();
+    vocalSuggestionChanged.sendChangeMessage();
+}
+
+void MerjEQAudioProcessor::applyVocalSuggestion()
+{
+    if (!vocalSuggestion.valid)
+        return;
+
+    vocalSuggestionApplied = true;
+    const CoefficientUpdater::ScopedBulkUpdate bulk(coefficientUpdater);
+    auto set = [this](const char* id, float value) {
+        if (auto* param = apvts.getParameter(id)) {
+            param->beginChangeGesture();
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+            param->endChangeGesture();
+        }
+    };
+    set("LowGain", vocalSuggestion.eq.lowGain);
+    set("MidGain", vocalSuggestion.eq.midGain);
+    set("HighGain", vocalSuggestion.eq.highGain);
+    set("MidQ", vocalSuggestion.eq.midQ);
+}
+#endif
+
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 {
     return new MerjEQAudioProcessor();
@@ -10,8 +10,30 @@
 
 #include <JuceHeader.h>
 #include <array>
+#include <vector>
+#include "MerjEQCore.h"
+#include "CoefficientUpdater.h"
+#include "OversampledSaturator.h"
+#include "SpectrumAnalyzer.h"
+#include "LinearPhaseEQ.h"
+#include "PluginState.h"
+#include "PresetBank.h"
+#include "DSPProfiler.h"
+#if JucePlugin_Enable_ARA
+ #include "VocalDocumentController.h"
+#endif
 
-class MerjEQAudioProcessor : public juce::AudioProcessor
+// Outils console (rendu batch, benchmarks) : processeur sans éditeur ni BinaryData
+#ifndef MERJEQ_HEADLESS
+ #define MERJEQ_HEADLESS 0
+#endif
+
+class MerjEQAudioProcessor : public juce::AudioProcessor,
+                            #if JucePlugin_Enable_ARA
+                             public juce::AudioProcessorARAExtension,
+                             private juce::Timer,
+                            #endif
+                             private juce::AsyncUpdater
 {
 public:
     MerjEQAudioProcessor();
@@ -19,7 +41,10 @@ public:
 
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override;
 
     juce::AudioProcessorEditor* createEditor() override;
     bool hasEditor() const override;
@@ -45,11 +70,131 @@ public:
     // === Saturation ON/OFF ===
     bool saturationEnabled = false;
 
+    // === Moteur de filtrage (A/B) ===
+    enum class FilterEngine
+    {
+        legacyIIR = 0,      // chaîne juce::dsp::IIR::Filter d'origine, 3 passes
+        fusedCascade,       // cascade biquad SIMD en une passe
+        stateVariable,      // SVF TPT, paramètres lissés (sans zipper noise)
+        linearPhase,        // FIR phase linéaire, convolution FFT partitionnée (latence ~50 ms)
+        dynamic             // SVF dont le gain des bandes dynamiques suit leur niveau
+    };
+    std::atomic<FilterEngine> filterEngine { FilterEngine::fusedCascade };
+
+    // Spectre avant/après EQ pour l'éditeur (quasi gratuit tant qu'il est fermé)
+    SpectrumAnalyzer analyzer;
+
+    // Coût DSP par étape, mesuré seulement tant que la surcouche de l'éditeur ou l'export est ouvert
+    DSPProfiler profiler;
+
+    // Mono à 7.1.4 et ambisonie jusqu'à l'ordre 7 (64 canaux), entrée = sortie
+    static constexpr int maxChannels = 64;
+
+   #if JucePlugin_Enable_ARA
+    // === ARA : point de départ proposé d'après les prises analysées de la piste ===
+    // Thread de message. Appliqué d'office une fois à une instance neuve (pas à une
+    // instance restaurée d'une session), ensuite seulement à la demande.
+    VocalSuggestion getVocalSuggestion() const noexcept { return vocalSuggestion; }
+    void applyVocalSuggestion();
+    juce::ChangeBroadcaster vocalSuggestionChanged;
+   #endif
+
 private:
-    juce::dsp::IIR::Filter<float> lowShelfFilter[2];
-    juce::dsp::IIR::Filter<float> midBandFilter[2];
-    juce::dsp::IIR::Filter<float> highShelfFilter[2];
+    // Filtres JUCE par canal (dimensionnés dans prepareToPlay) ; un seul jeu de
+    // coefficients par bande, partagé par tous les canaux
+    std::vector<juce::dsp::IIR::Filter<float>> lowShelfFilter, midBandFilter, highShelfFilter;
+    juce::dsp::IIR::Coefficients<float>::Ptr lowShelfCoefficients, midBandCoefficients, highShelfCoefficients;
+    FilterEngine activeEngine = FilterEngine::fusedCascade;
     double lastSampleRate = 44100.0;
+
+    // Coefficients conçus hors du thread audio, propres à cette instance
+    CoefficientUpdater coefficientUpdater { apvts };
+    LinearPhaseEQ linearPhaseEQ { coefficientUpdater };
+    EQCoefficientSet activeCoefficients;
+    std::atomic<float>* saturationParam = nullptr;
+    std::atomic<float>* saturationQualityParam = nullptr;
+    std::atomic<float>* oversamplingFactorParam = nullptr;
+    std::atomic<float>* oversamplingFilterParam = nullptr;
+    std::atomic<float>* linearPhaseParam = nullptr;
+    std::array<std::atomic<float>*, EQBands::numBands> dynamicParams {}, thresholdParams {};
+    std::atomic<float>* dynamicAttackParam = nullptr;
+    std::atomic<float>* dynamicReleaseParam = nullptr;
+
+    // Standalone : export périodique des mesures (--profile-dump)
+    std::unique_ptr<ProfileDumper> profileDumper;
+
+    // Latence annoncée à l'hôte ; l'AsyncUpdater applique aussi les paramètres d'un preset
+    std::atomic<int> reportedLatency { 0 };
+    void handleAsyncUpdate() override;
+
+    // Presets : le thread audio prend tout de suite les coefficients précalculés
+    // (fondu croisé du moteur entre l'ancienne et la nouvelle cascade), les paramètres suivent
+    // sur le thread de message. Chaque changement de programme a un numéro, qui devient la
+    // génération du CoefficientUpdater une fois ses paramètres appliqués : les jeux conçus
+    // d'après des paramètres plus anciens sont ignorés, même publiés après coup.
+    PresetBank presets;
+    std::atomic<int> currentProgram { 0 };
+    std::atomic<int> pendingProgram { -1 };        // lu par le thread audio
+    std::atomic<int> programToApply { -1 };        // lu par le thread de message
+    std::atomic<int> programRequests { 0 };        // numéro du dernier changement demandé
+    int requiredGeneration = 0;                    // thread audio : depuis le dernier fondu de preset
+
+    // Moteur sans JUCE (cascade, SVF, dynamique, contournement et fondus) et saturation
+    // suréchantillonnée dans la précision de l'hôte : seul le jeu utilisé est préparé,
+    // sans conversion float <-> double.
+    // Un saturateur par partition de canaux du moteur (une seule hors rendu offline)
+    template <typename SampleType>
+    struct PrecisionState
+    {
+        MerjEQCore<SampleType> core;
+        std::vector<OversampledSaturator<SampleType>> saturators = std::vector<OversampledSaturator<SampleType>>(1);
+        std::array<SampleType*, maxChannels> channelPointers {};
+    };
+    PrecisionState<float> floatState;
+    PrecisionState<double> doubleState;
+
+    // Filtres JUCE d'origine et phase linéaire (FFT float) : aller-retour par ce buffer en double
+    juce::AudioBuffer<float> conversionBuffer;
+
+    // Rendu offline : partitions de canaux traitées en parallèle par des workers partagés
+    // par toutes les instances (le thread de rendu y participe et attend la fin du bloc)
+    juce::SharedResourcePointer<WorkStealingPool> workers;
+
+    // Entrée silencieuse ignorée une fois la traîne écoulée (EQ neutre : contourné par le moteur)
+    std::atomic<int> eqTailSamples { 0 };
+    int silentSamples = 0;
+
+   #if JucePlugin_Enable_ARA
+    // Profils des prises relevés quelques fois par seconde, fusionnés puis comparés à la cible
+    void timerCallback() override;
+    VocalSuggestion vocalSuggestion;
+    std::atomic<bool> vocalSuggestionApplied { false };
+    juce::AudioBuffer<float> araRenderBuffer;       // régions rendues en float, traitées en double
+   #endif
+
     void updateFilters();
+    void applyCoefficients();
+    void resetFilters();
+    template <typename SampleType>
+    void prepareState(PrecisionState<SampleType>& state, double sampleRate, int numChannels, int samplesPerBlock, int maxPartitions);
+    template <typename SampleType>
+    bool isEQNeutral(FilterEngine engine, const PrecisionState<SampleType>& state) const noexcept;
+    FilterEngine selectedEngine() const noexcept;
+    DynamicEQSettings dynamicSettings() const noexcept;
+    MerjEQCoreParameters coreParameters(FilterEngine engine) const noexcept;
+    int engineLatencySamples(FilterEngine engine) const noexcept;
+    int engineTailSamples(FilterEngine engine) const noexcept;
+    int saturatorLatencySamples() const noexcept;
+    int saturatorTailSamples() const noexcept;
+    template <typename SampleType>
+    void processSamples(juce::AudioBuffer<SampleType>& buffer, PrecisionState<SampleType>& state) noexcept;
+    template <typename SampleType>
+    void processEQ(PrecisionState<SampleType>& state, SampleType* const* channels, int numChannels, int numSamples) noexcept;
+    // resetMissing : un paramètre absent revient à sa valeur par défaut (état de session) ;
+    // sinon il garde sa valeur (preset, qui ne porte que les réglages d'EQ et de saturation)
+    void applyParameterValues(const juce::Array<ParameterValue>& values, bool resetMissing);
+    void applyPendingProgram();
+    template <typename SampleType>
+    void startProgramFade(PrecisionState<SampleType>& state, int program) noexcept;
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MerjEQAudioProcessor)
 };
@@ -0,0 +1,79 @@
+#include "PluginState.h"
+
+namespace
+{
+    bool readBinary(const void* data, int sizeInBytes, juce::Array<ParameterValue>& values)
+    {
+        juce::MemoryInputStream in(data, (size_t) sizeInBytes, false);
+        if ((juce::uint32) in.readInt() != PluginState::magic)
+            return false;
+
+        // Version plus récente que ce binaire : on ne devine pas sa structure
+        const int version = (juce::uint16) in.readShort();
+        if (version < 1 || version > PluginState::currentVersion)
+            return false;
+
+        const int count = (juce::uint16) in.readShort();
+        values.ensureStorageAllocated(count);
+        for (int i = 0; i < count; ++i) {
+            const int idLength = (juce::uint8) in.readByte();
+            if (in.getNumBytesRemaining() < idLength + (juce::int64) sizeof(float))
+                return false;
+
+            char id[256];
+            in.read(id, idLength);
+            const float value = in.readFloat();
+            values.add({ juce::String::fromUTF8(id, idLength), value });
+        }
+        return true;
+    }
+
+    // Arbre APVTS écrit par les versions précédentes : <Parameters><PARAM id=".." value=".."/>...
+    bool readXml(const void* data, int sizeInBytes, juce::Array<ParameterValue>& values)
+    {
+        const auto xml = juce::AudioProcessor::getXmlFromBinary(data, sizeInBytes);
+        if (xml == nullptr)
+            return false;
+
+        for (auto* child : xml->getChildIterator())
+            if (child->hasAttribute("id") && child->hasAttribute("value"))
+                values.add({ child->getStringAttribute("id"), (float) child->getDoubleAttribute("value") });
+        return true;
+    }
+}
+
+namespace PluginState
+{
+    void write(const juce::AudioProcessor& processor, juce::MemoryBlock& dest)
+    {
+        juce::Array<juce::RangedAudioParameter*> params;
+        for (auto* p : processor.getParameters())
+            if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*>(p))
+                params.add(ranged);
+
+        juce::MemoryOutputStream out(dest, false);
+        out.writeInt((int) magic);
+        out.writeShort((short) currentVersion);
+        out.writeShort((short) params.size());
+
+        for (auto* param : params) {
+            const auto id = param->getParameterID().toStdString();
+            const auto idLength = juce::jmin((size_t) 255, id.size());
+            out.writeByte((char) idLength);
+            out.write(id.data(), idLength);
+            out.writeFloat(param->convertFrom0to1(param->getValue()));
+        }
+    }
+
+    bool read(const void* data, int sizeInBytes, juce::Array<ParameterValue>& values)
+    {
+        values.clearQuick();
+        if (data == nullptr || sizeInBytes < 8)
+            return false;
+        if (readBinary(data, sizeInBytes, values))
+            return true;
+
+        values.clearQuick();
+        return readXml(data, sizeInBytes, values);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Valeur d'un paramètre en unités réelles (dB, Q, index de choix...)
+struct ParameterValue
+{
+    juce::String id;
+    float value = 0.0f;
+};
+
+// Sérialisation de l'état du plugin.
+// Format binaire compact (v1, little-endian) :
+//   uint32 magic "MRJS", uint16 version, uint16 nombre de paramètres,
+//   puis pour chaque paramètre : uint8 longueur de l'ID, ID (UTF-8), float32 valeur.
+// Environ 120 octets au lieu de ~700 en XML, lu sans parseur ni ValueTree.
+// Les anciennes sessions (XML de l'APVTS via copyXmlToBinary) restent lisibles.
+namespace PluginState
+{
+    constexpr juce::uint32 magic = 0x534a524d;   // "MRJS"
+    constexpr int currentVersion = 1;
+
+    // Tous les paramètres de processor, dans leur ordre de déclaration
+    void write(const juce::AudioProcessor& processor, juce::MemoryBlock& dest);
+
+    // Binaire (versions connues) ou XML historique ; false si illisible.
+    // Un paramètre absent n'apparaît pas dans values : à l'appelant de le remettre à sa valeur par défaut.
+    bool read(const void* data, int sizeInBytes, juce::Array<ParameterValue>& values);
+}
@@ -0,0 +1,139 @@
+#include "PresetBank.h"
+
+namespace
+{
+    EQParameters eqParametersOf(const juce::Array<ParameterValue>& values) noexcept
+    {
+        // Valeurs par défaut des paramètres pour ce qui n'est pas dans le preset
+        EQParameters p;
+        for (auto& v : values) {
+            if (v.id == "LowGain")       p.lowGain = v.value;
+            else if (v.id == "MidGain")  p.midGain = v.value;
+            else if (v.id == "HighGain") p.highGain = v.value;
+            else if (v.id == "MidQ")     p.midQ = v.value;
+        }
+        return p;
+    }
+
+    struct FactoryPreset
+    {
+        const char* name;
+        float lowGain, midGain, highGain, midQ;
+        bool saturation;
+    };
+
+    // Traitements voix de départ (gains en dB)
+    const FactoryPreset factoryPresets[] = {
+        { "Neutre",          0.0f,  0.0f,  0.0f, 1.0f, false },
+        { "Voix claire",    -2.0f,  2.0f,  3.0f, 0.8f, false },
+        { "Voix chaude",     3.0f, -1.5f, -2.0f, 1.0f, true  },
+        { "Présence",        0.0f,  4.0f,  2.0f, 1.5f, false },
+        { "De-boom",        -6.0f,  0.0f,  1.0f, 1.0f, false },
+        { "Radio",         -12.0f,  6.0f, -6.0f, 2.0f, true  },
+    };
+}
+
+PresetBank::PresetBank()
+{
+    if (!loadLibrary(getDefaultLibraryFile()))
+        loadFactoryPresets();
+}
+
+juce::File PresetBank::getDefaultLibraryFile()
+{
+    return juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory)
+               .getChildFile("MerjEQ").getChildFile("Presets.mrjbank");
+}
+
+bool PresetBank::loadLibrary(const juce::File& file)
+{
+    if (!file.existsAsFile())
+        return false;
+
+    // Projection en lecture seule : pas de copie du fichier, lecture directe des états
+    juce::MemoryMappedFile mapped(file, juce::MemoryMappedFile::readOnly);
+    if (mapped.getData() == nullptr)
+        return false;
+
+    juce::MemoryInputStream in(mapped.getData(), mapped.getSize(), false);
+    if ((juce::uint32) in.readInt() != magic || (juce::uint16) in.readShort() != currentVersion)
+        return false;
+
+    const int count = (juce::uint16) in.readShort();
+    std::vector<Preset> loaded;
+    loaded.reserve((size_t) count);
+
+    for (int i = 0; i < count; ++i) {
+        const int nameLength = (juce::uint8) in.readByte();
+        if (in.getNumBytesRemaining() < nameLength + 4)
+            return false;
+        const auto* base = static_cast<const char*>(mapped.getData());
+        const auto name = juce::String::fromUTF8(base + in.getPosition(), nameLength);
+        in.skipNextBytes(nameLength);
+
+        const auto stateSize = (juce::int64) (juce::uint32) in.readInt();
+        if (in.getNumBytesRemaining() < stateSize)
+            return false;
+
+        Preset preset;
+        preset.name = name;
+        if (!PluginState::read(base + in.getPosition(), (int) stateSize, preset.values))
+            return false;
+        preset.eq = eqParametersOf(preset.values);
+        in.skipNextBytes(stateSize);
+        loaded.push_back(std::move(preset));
+    }
+
+    if (loaded.empty())
+        return false;
+
+    presets = std::move(loaded);
+    computeCoefficients();
+    return true;
+}
+
+void PresetBank::loadFactoryPresets()
+{
+    presets.clear();
+    for (auto& f : factoryPresets) {
+        Preset preset;
+        preset.name = juce::String::fromUTF8(f.name);
+        preset.values = { { "LowGain", f.lowGain }, { "MidGain", f.midGain }, { "HighGain", f.highGain },
+                          { "MidQ", f.midQ }, { "saturationEnabled", f.saturation ? 1.0f : 0.0f } };
+        preset.eq = eqParametersOf(preset.values);
+        presets.push_back(std::move(preset));
+    }
+    computeCoefficients();
+}
+
+void PresetBank::prepare(double newSampleRate)
+{
+    sampleRate = newSampleRate;
+    computeCoefficients();
+}
+
+void PresetBank::computeCoefficients()
+{
+    // Conception directe, sans attendre la table partagée : les jeux sont prêts dès le chargement
+    coefficients.resize(presets.size());
+    for (size_t i = 0; i < presets.size(); ++i) {
+        auto& set = coefficients[i];
+        set.sampleRate = sampleRate;
+        for (int b = 0; b < EQBands::numBands; ++b) {
+            set.preciseBands[(size_t) b] = EQDesign::makeBandPrecise(b, sampleRate, presets[i].eq);
+            set.bands[(size_t) b] = EQDesign::toFloat(set.preciseBands[(size_t) b]);
+        }
+    }
+}
+
+const PresetBank::Preset& PresetBank::getPreset(int index) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, size()));
+    return presets[(size_t) juce::jlimit(0, size() - 1, index)];
+}
+
+const EQCoefficientSet& PresetBank::getCoefficients(int index) const noexcept
+{
+    jassert(juce::isPositiveAndBelow(index, size()));
+    return coefficients[(size_t) juce::jlimit(0, size() - 1, index)];
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <JuceHeader.h>
+#include <vector>
+#include "EQCoefficients.h"
+#include "PluginState.h"
+
+// Banque de presets exposée par l'API program de l'hôte.
+// La bibliothèque est lue depuis un fichier projeté en mémoire (lecture seule) ;
+// sans fichier, ce sont les presets d'usine. Les coefficients de chaque preset sont
+// calculés d'avance pour la fréquence courante : sur le thread audio, changer de
+// preset revient à prendre un pointeur vers un jeu déjà prêt.
+//
+// Fichier (little-endian) : uint32 magic "MRJB", uint16 version, uint16 nombre de presets,
+// puis pour chacun : uint8 longueur du nom, nom (UTF-8), uint32 taille, état au format PluginState.
+class PresetBank
+{
+public:
+    struct Preset
+    {
+        juce::String name;
+        juce::Array<ParameterValue> values;   // appliqué sur le thread de message, les absents gardent leur valeur
+        EQParameters eq;
+    };
+
+    static constexpr juce::uint32 magic = 0x424a524d;   // "MRJB"
+    static constexpr int currentVersion = 1;
+
+    // Bibliothèque par défaut si elle existe et se lit, sinon presets d'usine
+    PresetBank();
+
+    // false (banque inchangée) si le fichier est absent ou invalide. Hors thread audio, audio arrêté.
+    bool loadLibrary(const juce::File& file);
+    static juce::File getDefaultLibraryFile();
+
+    // Audio arrêté (prepareToPlay) : un jeu de coefficients par preset
+    void prepare(double sampleRate);
+
+    int size() const noexcept { return (int) presets.size(); }
+    const Preset& getPreset(int index) const noexcept;
+
+    // Thread audio : jeu précalculé, ni calcul ni allocation
+    const EQCoefficientSet& getCoefficients(int index) const noexcept;
+
+private:
+    void loadFactoryPresets();
+    void computeCoefficients();
+
+    std::vector<Preset> presets;
+    std::vector<EQCoefficientSet> coefficients;
+    double sampleRate = 44100.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetBank)
+};
@@ -0,0 +1,78 @@
+#include "ProfilerOverlay.h"
+
+ProfilerOverlay::ProfilerOverlay(DSPProfiler& p)
+    : profiler(p)
+{
+    setOpaque(false);
+    setInterceptsMouseClicks(false, false);
+}
+
+ProfilerOverlay::~ProfilerOverlay()
+{
+    setViewing(false);
+}
+
+void ProfilerOverlay::visibilityChanged()
+{
+    setViewing(isVisible());
+}
+
+void ProfilerOverlay::setViewing(bool shouldView)
+{
+    if (shouldView == viewing)
+        return;
+    viewing = shouldView;
+
+    if (viewing) {
+        profiler.addViewer();
+        knobFilmstrips->addViewer();
+        startTimerHz(refreshHz);
+    } else {
+        stopTimer();
+        profiler.removeViewer();
+        knobFilmstrips->removeViewer();
+    }
+}
+
+void ProfilerOverlay::timerCallback()
+{
+    const auto& knobStats = knobFilmstrips->getStats();
+    const auto knobPaints = knobStats.filmstripPaints + knobStats.directPaints;
+    if (profiler.pullSnapshot(snapshot) || knobPaints != knobPaintsShown)
+        repaint();
+}
+
+void ProfilerOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::black.withAlpha(0.75f));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    juce::String text;
+    text << "bloc " << juce::String(snapshot.meanBlockMicros, 1) << " us (max " << juce::String(snapshot.maxBlockMicros, 1) << ")\n"
+         << "budget " << juce::String(snapshot.budgetPercent, 2) << " % (max " << juce::String(snapshot.maxBudgetPercent, 1) << " %)\n"
+         << "blocs " << snapshot.blocksProcessed << ", coeffs " << snapshot.coefficientUpdates << "\n";
+
+    // Étapes non mesurées avec le moteur courant (bandes séparées ou passe unique) omises
+    for (int i = 0; i < DSPProfiler::numStages; ++i) {
+        const double micros = snapshot.stageMicros[(size_t) i];
+        if (micros > 0.0)
+            text << DSPProfiler::getStageName((DSPProfiler::Stage) i) << " " << juce::String(micros, 2) << " us\n";
+    }
+
+    // Knobs : moyenne du chemin utilisé (filmstrip ou rotation directe)
+    const auto& knobStats = knobFilmstrips->getStats();
+    knobPaintsShown = knobStats.filmstripPaints + knobStats.directPaints;
+    if (knobFilmstrips->isEnabled())
+        text << "knob filmstrip " << juce::String(knobStats.averageFilmstripMicroseconds(), 1) << " us, "
+             << knobStats.bytesUsed / 1024 << " KB\n";
+    else
+        text << "knob direct " << juce::String(knobStats.averageDirectMicroseconds(), 1) << " us\n";
+
+    const auto editorStats = resources->getStats();
+    text << "editeur " << juce::String(editorStats.lastEditorOpenMilliseconds, 1) << " ms, " << editorStats.numEditors
+         << " ouvert(s), " << editorStats.sharedImageBytes / 1024 << " KB\n";
+
+    g.setColour(juce::Colour::fromRGB(192, 192, 192)); // argenté
+    g.setFont(juce::Font(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain)));
+    g.drawFittedText(text.trimEnd(), getLocalBounds().reduced(6, 4), juce::Justification::topLeft, 12);
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <JuceHeader.h>
+#include "DSPProfiler.h"
+#include "EditorResources.h"
+#include "KnobFilmstrip.h"
+
+// Surcouche compacte des mesures DSP de l'instance (µs par bloc, % du budget temps réel),
+// du temps de dessin moyen des knobs et du coût d'ouverture de l'éditeur. Le profiler et les knobs ne mesurent que tant que
+// la surcouche est visible ; les instantanés sont relus quatre fois par seconde et le
+// composant n'est invalidé que s'il en arrive un nouveau.
+class ProfilerOverlay : public juce::Component,
+                        private juce::Timer
+{
+public:
+    explicit ProfilerOverlay(DSPProfiler& profiler);
+    ~ProfilerOverlay() override;
+
+    void paint(juce::Graphics&) override;
+    void visibilityChanged() override;
+
+private:
+    static constexpr int refreshHz = 4;
+
+    void timerCallback() override;
+    void setViewing(bool shouldView);
+
+    DSPProfiler& profiler;
+    DSPProfiler::Snapshot snapshot;
+    juce::SharedResourcePointer<KnobFilmstripCache> knobFilmstrips;
+    juce::SharedResourcePointer<EditorResources> resources;
+    juce::int64 knobPaintsShown = 0;
+    bool viewing = false;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
@@ -0,0 +1,93 @@
+#include "RegionPlaybackRenderer.h"
+
+#if JucePlugin_Enable_ARA
+void RegionPlaybackRenderer::prepareToPlay(double rate, int maxBlock, int channels,
+                                           juce::AudioProcessor::ProcessingPrecision, AlwaysNonRealtime alwaysNonRealtime)
+{
+    sampleRate = rate;
+    numChannels = channels;
+    maximumSamplesPerBlock = maxBlock;
+    buffered = alwaysNonRealtime == AlwaysNonRealtime::no;
+    regionBuffer.setSize(numChannels, maximumSamplesPerBlock);
+
+    readers.clear();
+    for (auto* region : getPlaybackRegions()) {
+        auto* source = region->getAudioModification()->getAudioSource();
+        if (readers.find(source) != readers.end())
+            continue;
+        auto reader = std::make_unique<juce::ARAAudioSourceReader>(source);
+        if (buffered) {
+            const int readAhead = juce::jmax(4 * maximumSamplesPerBlock, juce::roundToInt(2.0 * sampleRate));
+            readers.emplace(source, std::make_unique<juce::BufferingAudioReader>(reader.release(), *readingThread, readAhead));
+        } else {
+            readers.emplace(source, std::move(reader));
+        }
+    }
+}
+
+void RegionPlaybackRenderer::releaseResources()
+{
+    readers.clear();
+    regionBuffer.setSize(0, 0);
+}
+
+bool RegionPlaybackRenderer::processBlock(juce::AudioBuffer<float>& buffer, juce::AudioProcessor::Realtime realtime,
+                                          const juce::AudioPlayHead::PositionInfo& positionInfo) noexcept
+{
+    const int numSamples = buffer.getNumSamples();
+    jassert(numSamples <= maximumSamplesPerBlock && buffer.getNumChannels() == numChannels);
+
+    bool success = true;
+    bool renderedAny = false;
+
+    if (positionInfo.getIsPlaying()) {
+        const auto block = juce::Range<juce::int64>::withStartAndLength(positionInfo.getTimeInSamples().orFallback(0), numSamples);
+
+        for (auto* region : getPlaybackRegions()) {
+            // Pas d'étirement temporel : décalage constant entre la chanson et la prise
+            const auto playbackRange = region->getSampleRange(sampleRate, juce::ARAPlaybackRegion::IncludeHeadAndTail::no);
+            const juce::Range<juce::int64> modificationRange { region->getStartInAudioModificationSamples(),
+                                                               region->getEndInAudioModificationSamples() };
+            const auto render = block.getIntersectionWith(playbackRange)
+                                     .getIntersectionWith(modificationRange.movedToStartAt(playbackRange.getStart()));
+            if (render.isEmpty())
+                continue;
+
+            auto* source = region->getAudioModification()->getAudioSource();
+            const auto reader = readers.find(source);
+            if (reader == readers.end() || source->getChannelCount() != numChannels || source->getSampleRate() != sampleRate) {
+                success = false;
+                continue;
+            }
+            if (auto* bufferingReader = dynamic_cast<juce::BufferingAudioReader*>(reader->second.get()))
+                bufferingReader->setReadTimeout(realtime == juce::AudioProcessor::Realtime::no ? 100 : 0);
+
+            const int length = (int) render.getLength();
+            const int startInBuffer = (int) (render.getStart() - block.getStart());
+            const auto startInSource = render.getStart() + modificationRange.getStart() - playbackRange.getStart();
+
+            // Première région écrite directement dans la sortie, les suivantes mélangées
+            auto& destination = renderedAny ? regionBuffer : buffer;
+            if (!reader->second->read(&destination, startInBuffer, length, startInSource, true, true)) {
+                success = false;
+                continue;
+            }
+
+            if (renderedAny) {
+                for (int ch = 0; ch < numChannels; ++ch)
+                    buffer.addFrom(ch, startInBuffer, regionBuffer, ch, startInBuffer, length);
+            } else {
+                if (startInBuffer > 0)
+                    buffer.clear(0, startInBuffer);
+                if (startInBuffer + length < numSamples)
+                    buffer.clear(startInBuffer + length, numSamples - startInBuffer - length);
+                renderedAny = true;
+            }
+        }
+    }
+
+    if (!renderedAny)
+        buffer.clear();
+    return success;
+}
+#endif
@@ -0,0 +1,37 @@
+#pragma once
+#include <JuceHeader.h>
+
+#if JucePlugin_Enable_ARA
+#include <map>
+#include <memory>
+
+// Rendu ARA des régions de la piste : l'EQ s'applique ensuite au bloc rendu, comme à l'entrée
+// d'une insertion classique. Lecteurs bufferisés (thread de lecture partagé) en temps réel,
+// lecture directe quand l'hôte garantit un rendu offline.
+// Prises de fréquence ou de nombre de canaux différents de la piste : non rendues (silence).
+class RegionPlaybackRenderer : public juce::ARAPlaybackRenderer
+{
+public:
+    using juce::ARAPlaybackRenderer::ARAPlaybackRenderer;
+
+    void prepareToPlay(double sampleRate, int maximumSamplesPerBlock, int numChannels,
+                       juce::AudioProcessor::ProcessingPrecision precision, AlwaysNonRealtime alwaysNonRealtime) override;
+    void releaseResources() override;
+    bool processBlock(juce::AudioBuffer<float>& buffer, juce::AudioProcessor::Realtime realtime,
+                      const juce::AudioPlayHead::PositionInfo& positionInfo) noexcept override;
+
+private:
+    struct ReadingThread : public juce::TimeSliceThread
+    {
+        ReadingThread() : juce::TimeSliceThread("MerjEQ ARA reader") { startThread(Priority::high); }
+    };
+
+    juce::SharedResourcePointer<ReadingThread> readingThread;
+    std::map<juce::ARAAudioSource*, std::unique_ptr<juce::AudioFormatReader>> readers;
+    juce::AudioBuffer<float> regionBuffer;        // régions suivantes, mélangées à la première
+    double sampleRate = 44100.0;
+    int numChannels = 2;
+    int maximumSamplesPerBlock = 0;
+    bool buffered = true;
+};
+#endif
@@ -0,0 +1,98 @@
+#include "ResponseCurveDisplay.h"
+
+namespace
+{
+    const char* const responseParameterIDs[] = { "LowGain", "MidGain", "HighGain", "MidQ" };
+    constexpr int allBands = (1 << EQBands::numBands) - 1;
+
+    int bandMaskFor(const juce::String& parameterID) noexcept
+    {
+        if (parameterID == "LowGain") return 1 << EQBands::low;
+        if (parameterID == "MidGain" || parameterID == "MidQ") return 1 << EQBands::mid;
+        if (parameterID == "HighGain") return 1 << EQBands::high;
+        return 0;
+    }
+}
+
+ResponseCurveDisplay::ResponseCurveDisplay(juce::AudioProcessor& p, juce::AudioProcessorValueTreeState& state)
+    : processor(p), apvts(state)
+{
+    setOpaque(false);
+    setInterceptsMouseClicks(false, false);
+
+    lowGain = apvts.getRawParameterValue("LowGain");
+    midGain = apvts.getRawParameterValue("MidGain");
+    highGain = apvts.getRawParameterValue("HighGain");
+    midQ = apvts.getRawParameterValue("MidQ");
+    for (auto* id : responseParameterIDs)
+        apvts.addParameterListener(id, this);
+
+    dirtyBands = allBands;
+    refresh();
+}
+
+ResponseCurveDisplay::~ResponseCurveDisplay()
+{
+    for (auto* id : responseParameterIDs)
+        apvts.removeParameterListener(id, this);
+}
+
+void ResponseCurveDisplay::parameterChanged(const juce::String& parameterID, float)
+{
+    // Peut venir du thread audio (automation) : uniquement un atomique
+    dirtyBands.fetch_or(bandMaskFor(parameterID));
+}
+
+void ResponseCurveDisplay::refresh()
+{
+    // Fréquence de l'hôte (44.1 kHz tant que le processeur n'est pas préparé)
+    const double rate = processor.getSampleRate() > 0.0 ? processor.getSampleRate() : 44100.0;
+    if (rate != response.getSampleRate()) {
+        response.setSampleRate(rate);
+        dirtyBands = allBands;
+    }
+
+    const int mask = dirtyBands.exchange(0);
+    if (mask == 0)
+        return;
+
+    response.update(mask, { lowGain->load(), midGain->load(), highGain->load(), midQ->load() });
+    updatePaths();
+    repaint();
+}
+
+void ResponseCurveDisplay::resized()
+{
+    updatePaths();
+}
+
+void ResponseCurveDisplay::updatePaths()
+{
+    const float width = (float) getWidth();
+    const float height = (float) getHeight();
+    const auto& magnitude = response.getMagnitudeDb();
+    const auto& phase = response.getPhase();
+
+    magnitudePath.clear();
+    phasePath.clear();
+    for (int i = 0; i < EQResponse::numPoints; ++i) {
+        const float x = width * (float) i / (float) (EQResponse::numPoints - 1);
+        const float yMagnitude = juce::jmap(juce::jlimit(-rangeDb, rangeDb, magnitude[(size_t) i]), -rangeDb, rangeDb, height, 0.0f);
+        const float yPhase = juce::jmap(phase[(size_t) i], -juce::MathConstants<float>::pi, juce::MathConstants<float>::pi, height, 0.0f);
+        if (i == 0) {
+            magnitudePath.startNewSubPath(x, yMagnitude);
+            phasePath.startNewSubPath(x, yPhase);
+        } else {
+            magnitudePath.lineTo(x, yMagnitude);
+            phasePath.lineTo(x, yPhase);
+        }
+    }
+}
+
+void ResponseCurveDisplay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colours::white.withAlpha(0.25f));
+    g.strokePath(phasePath, juce::PathStrokeType(1.0f));
+    g.setColour(juce::Colours::white.withAlpha(0.9f));
+    g.strokePath(magnitudePath, juce::PathStrokeType(2.0f));
+}
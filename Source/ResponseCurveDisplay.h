@@ -0,0 +1,40 @@
+#pragma once
+#include <JuceHeader.h>
+#include "EQResponse.h"
+
+// Courbe de réponse de l'EQ (amplitude, et phase en discret) superposée au spectre.
+// Les listeners de paramètres ne font que marquer la bande modifiée ; la bande est
+// réévaluée au rythme de l'écran (VBlankAttachment), jamais dans paint() ni sur le
+// thread audio, et le chemin n'est reconstruit que si quelque chose a changé.
+class ResponseCurveDisplay : public juce::Component,
+                             private juce::AudioProcessorValueTreeState::Listener
+{
+public:
+    ResponseCurveDisplay(juce::AudioProcessor& processor, juce::AudioProcessorValueTreeState& state);
+    ~ResponseCurveDisplay() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    static constexpr float rangeDb = 15.0f;    // ±15 dB sur la hauteur du composant
+
+    void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void refresh();
+    void updatePaths();
+
+    juce::AudioProcessor& processor;
+    juce::AudioProcessorValueTreeState& apvts;
+    std::atomic<float>* lowGain = nullptr;
+    std::atomic<float>* midGain = nullptr;
+    std::atomic<float>* highGain = nullptr;
+    std::atomic<float>* midQ = nullptr;
+    std::atomic<int> dirtyBands { 0 };
+
+    EQResponse response;
+    juce::Path magnitudePath, phasePath;
+
+    juce::VBlankAttachment vBlankAttachment { this, [this] { refresh(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ResponseCurveDisplay)
+};
@@ -0,0 +1,202 @@
+#pragma once
+#include <cstddef>
+#include <cstring>
+
+#if defined(__AVX__)
+ #include <immintrin.h>
+ #define MERJEQ_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+ #include <emmintrin.h>
+ #define MERJEQ_SIMD_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+ #include <arm_neon.h>
+ #define MERJEQ_SIMD_NEON 1
+#endif
+
+// Registre SIMD natif, sans JUCE : même interface (et même largeur) que le sous-ensemble
+// de juce::dsp::SIMDRegister utilisé par les moteurs — float x4 / double x2 en SSE2 et NEON,
+// float x8 / double x4 en AVX, tableau de 16 octets sinon.
+// fromRawArray / copyToRawArray acceptent des tableaux non alignés.
+namespace SIMDNative
+{
+    template <typename T> struct Ops;
+
+    // Repli portable : boucles sur 16 octets, vectorisées par le compilateur s'il le peut
+    template <typename T>
+    struct Fallback
+    {
+        static constexpr size_t size = 16 / sizeof(T);
+        struct Native { T v[size]; };
+
+        static Native expand(T s) noexcept { Native r; for (auto& x : r.v) x = s; return r; }
+        static Native load(const T* p) noexcept { Native r; std::memcpy(r.v, p, sizeof(r.v)); return r; }
+        static void store(T* p, Native a) noexcept { std::memcpy(p, a.v, sizeof(a.v)); }
+        static Native add(Native a, Native b) noexcept { for (size_t i = 0; i < size; ++i) a.v[i] += b.v[i]; return a; }
+        static Native sub(Native a, Native b) noexcept { for (size_t i = 0; i < size; ++i) a.v[i] -= b.v[i]; return a; }
+        static Native mul(Native a, Native b) noexcept { for (size_t i = 0; i < size; ++i) a.v[i] *= b.v[i]; return a; }
+        static Native min(Native a, Native b) noexcept { for (size_t i = 0; i < size; ++i) a.v[i] = b.v[i] < a.v[i] ? b.v[i] : a.v[i]; return a; }
+        static Native max(Native a, Native b) noexcept { for (size_t i = 0; i < size; ++i) a.v[i] = b.v[i] > a.v[i] ? b.v[i] : a.v[i]; return a; }
+    };
+
+   #if MERJEQ_SIMD_AVX
+    template <> struct Ops<float>
+    {
+        using Native = __m256;
+        static constexpr size_t size = 8;
+        static Native expand(float s) noexcept { return _mm256_set1_ps(s); }
+        static Native load(const float* p) noexcept { return _mm256_loadu_ps(p); }
+        static void store(float* p, Native a) noexcept { _mm256_storeu_ps(p, a); }
+        static Native add(Native a, Native b) noexcept { return _mm256_add_ps(a, b); }
+        static Native sub(Native a, Native b) noexcept { return _mm256_sub_ps(a, b); }
+        static Native mul(Native a, Native b) noexcept { return _mm256_mul_ps(a, b); }
+        static Native min(Native a, Native b) noexcept { return _mm256_min_ps(a, b); }
+        static Native max(Native a, Native b) noexcept { return _mm256_max_ps(a, b); }
+    };
+
+    template <> struct Ops<double>
+    {
+        using Native = __m256d;
+        static constexpr size_t size = 4;
+        static Native expand(double s) noexcept { return _mm256_set1_pd(s); }
+        static Native load(const double* p) noexcept { return _mm256_loadu_pd(p); }
+        static void store(double* p, Native a) noexcept { _mm256_storeu_pd(p, a); }
+        static Native add(Native a, Native b) noexcept { return _mm256_add_pd(a, b); }
+        static Native sub(Native a, Native b) noexcept { return _mm256_sub_pd(a, b); }
+        static Native mul(Native a, Native b) noexcept { return _mm256_mul_pd(a, b); }
+        static Native min(Native a, Native b) noexcept { return _mm256_min_pd(a, b); }
+        static Native max(Native a, Native b) noexcept { return _mm256_max_pd(a, b); }
+    };
+   #elif MERJEQ_SIMD_SSE
+    template <> struct Ops<float>
+    {
+        using Native = __m128;
+        static constexpr size_t size = 4;
+        static Native expand(float s) noexcept { return _mm_set1_ps(s); }
+        static Native load(const float* p) noexcept { return _mm_loadu_ps(p); }
+        static void store(float* p, Native a) noexcept { _mm_storeu_ps(p, a); }
+        static Native add(Native a, Native b) noexcept { return _mm_add_ps(a, b); }
+        static Native sub(Native a, Native b) noexcept { return _mm_sub_ps(a, b); }
+        static Native mul(Native a, Native b) noexcept { return _mm_mul_ps(a, b); }
+        static Native min(Native a, Native b) noexcept { return _mm_min_ps(a, b); }
+        static Native max(Native a, Native b) noexcept { return _mm_max_ps(a, b); }
+    };
+
+    template <> struct Ops<double>
+    {
+        using Native = __m128d;
+        static constexpr size_t size = 2;
+        static Native expand(double s) noexcept { return _mm_set1_pd(s); }
+        static Native load(const double* p) noexcept { return _mm_loadu_pd(p); }
+        static void store(double* p, Native a) noexcept { _mm_storeu_pd(p, a); }
+        static Native add(Native a, Native b) noexcept { return _mm_add_pd(a, b); }
+        static Native sub(Native a, Native b) noexcept { return _mm_sub_pd(a, b); }
+        static Native mul(Native a, Native b) noexcept { return _mm_mul_pd(a, b); }
+        static Native min(Native a, Native b) noexcept { return _mm_min_pd(a, b); }
+        static Native max(Native a, Native b) noexcept { return _mm_max_pd(a, b); }
+    };
+   #elif MERJEQ_SIMD_NEON
+    template <> struct Ops<float>
+    {
+        using Native = float32x4_t;
+        static constexpr size_t size = 4;
+        static Native expand(float s) noexcept { return vdupq_n_f32(s); }
+        static Native load(const float* p) noexcept { return vld1q_f32(p); }
+        static void store(float* p, Native a) noexcept { vst1q_f32(p, a); }
+        static Native add(Native a, Native b) noexcept { return vaddq_f32(a, b); }
+        static Native sub(Native a, Native b) noexcept { return vsubq_f32(a, b); }
+        static Native mul(Native a, Native b) noexcept { return vmulq_f32(a, b); }
+        static Native min(Native a, Native b) noexcept { return vminq_f32(a, b); }
+        static Native max(Native a, Native b) noexcept { return vmaxq_f32(a, b); }
+    };
+
+    template <> struct Ops<double>
+    {
+        using Native = float64x2_t;
+        static constexpr size_t size = 2;
+        static Native expand(double s) noexcept { return vdupq_n_f64(s); }
+        static Native load(const double* p) noexcept { return vld1q_f64(p); }
+        static void store(double* p, Native a) noexcept { vst1q_f64(p, a); }
+        static Native add(Native a, Native b) noexcept { return vaddq_f64(a, b); }
+        static Native sub(Native a, Native b) noexcept { return vsubq_f64(a, b); }
+        static Native mul(Native a, Native b) noexcept { return vmulq_f64(a, b); }
+        static Native min(Native a, Native b) noexcept { return vminq_f64(a, b); }
+        static Native max(Native a, Native b) noexcept { return vmaxq_f64(a, b); }
+    };
+   #else
+    template <> struct Ops<float> : Fallback<float> {};
+    template <> struct Ops<double> : Fallback<double> {};
+   #endif
+
+    // Équivalent de juce::ScopedNoDenormals : les traînes des filtres retombent à zéro
+    // au lieu de s'éterniser en dénormaux (FTZ/DAZ en SSE, FZ en AArch64)
+    class ScopedNoDenormals
+    {
+    public:
+        ScopedNoDenormals() noexcept
+        {
+           #if MERJEQ_SIMD_AVX || MERJEQ_SIMD_SSE
+            saved = _mm_getcsr();
+            _mm_setcsr(saved | 0x8040u);
+           #elif MERJEQ_SIMD_NEON && ! defined(_MSC_VER)
+            asm volatile("mrs %0, fpcr" : "=r"(saved));
+            asm volatile("msr fpcr, %0" : : "r"(saved | (1ull << 24)));
+           #endif
+        }
+
+        ~ScopedNoDenormals() noexcept
+        {
+           #if MERJEQ_SIMD_AVX || MERJEQ_SIMD_SSE
+            _mm_setcsr(saved);
+           #elif MERJEQ_SIMD_NEON && ! defined(_MSC_VER)
+            asm volatile("msr fpcr, %0" : : "r"(saved));
+           #endif
+        }
+
+        ScopedNoDenormals(const ScopedNoDenormals&) = delete;
+        ScopedNoDenormals& operator=(const ScopedNoDenormals&) = delete;
+
+    private:
+       #if MERJEQ_SIMD_NEON
+        unsigned long long saved = 0;
+       #else
+        unsigned int saved = 0;
+       #endif
+    };
+}
+
+template <typename SampleType>
+struct SIMDVector
+{
+    using Ops = SIMDNative::Ops<SampleType>;
+    using NativeType = typename Ops::Native;
+    static constexpr size_t SIMDNumElements = Ops::size;
+
+    NativeType value;
+
+    static SIMDVector expand(SampleType s) noexcept { return { Ops::expand(s) }; }
+    static SIMDVector fromRawArray(const SampleType* a) noexcept { return { Ops::load(a) }; }
+    void copyToRawArray(SampleType* a) const noexcept { Ops::store(a, value); }
+
+    // Accès à une lane (hors boucle audio : passe par la mémoire)
+    SampleType get(size_t lane) const noexcept
+    {
+        SampleType lanes[SIMDNumElements];
+        copyToRawArray(lanes);
+        return lanes[lane];
+    }
+
+    void set(size_t lane, SampleType s) noexcept
+    {
+        SampleType lanes[SIMDNumElements];
+        copyToRawArray(lanes);
+        lanes[lane] = s;
+        value = Ops::load(lanes);
+    }
+
+    SIMDVector operator+(SIMDVector o) const noexcept { return { Ops::add(value, o.value) }; }
+    SIMDVector operator-(SIMDVector o) const noexcept { return { Ops::sub(value, o.value) }; }
+    SIMDVector operator*(SIMDVector o) const noexcept { return { Ops::mul(value, o.value) }; }
+
+    static SIMDVector min(SIMDVector a, SIMDVector b) noexcept { return { Ops::min(a.value, b.value) }; }
+    static SIMDVector max(SIMDVector a, SIMDVector b) noexcept { return { Ops::max(a.value, b.value) }; }
+};
@@ -0,0 +1,80 @@
+#pragma once
+#include <cmath>
+
+// Lissage de paramètre sans JUCE : mêmes rampes que juce::SmoothedValue<float>
+// (linéaire, ou multiplicative pour les grandeurs à échelle log comme le Q),
+// pour que le moteur donne le même résultat dans le plugin et hors du plugin.
+// Une rampe multiplicative ne doit jamais partir de 0 ni y aller.
+enum class SmoothingType { linear, multiplicative };
+
+template <SmoothingType type = SmoothingType::linear>
+class SmoothedParameter
+{
+public:
+    // Durée des rampes ; la valeur courante saute à la cible
+    void reset(double sampleRate, double rampLengthSeconds) noexcept
+    {
+        if (sampleRate > 0.0 && rampLengthSeconds >= 0.0)
+            stepsToTarget = (int) std::floor(rampLengthSeconds * sampleRate);
+        setCurrentAndTargetValue(target);
+    }
+
+    void setCurrentAndTargetValue(float newValue) noexcept
+    {
+        target = current = newValue;
+        countdown = 0;
+    }
+
+    void setTargetValue(float newValue) noexcept
+    {
+        if (newValue == target)
+            return;
+        if (stepsToTarget <= 0) {
+            setCurrentAndTargetValue(newValue);
+            return;
+        }
+        target = newValue;
+        countdown = stepsToTarget;
+        if constexpr (type == SmoothingType::linear)
+            step = (target - current) / (float) countdown;
+        else
+            step = std::exp((std::log(std::abs(target)) - std::log(std::abs(current))) / (float) countdown);
+    }
+
+    float getTargetValue() const noexcept { return target; }
+    float getCurrentValue() const noexcept { return current; }
+    bool isSmoothing() const noexcept { return countdown > 0; }
+
+    float getNextValue() noexcept
+    {
+        if (!isSmoothing())
+            return target;
+        if (--countdown > 0) {
+            if constexpr (type == SmoothingType::linear)
+                current += step;
+            else
+                current *= step;
+        } else {
+            current = target;
+        }
+        return current;
+    }
+
+    float skip(int numSamples) noexcept
+    {
+        if (numSamples >= countdown) {
+            setCurrentAndTargetValue(target);
+            return target;
+        }
+        if constexpr (type == SmoothingType::linear)
+            current += step * (float) numSamples;
+        else
+            current *= std::pow(step, (float) numSamples);
+        countdown -= numSamples;
+        return current;
+    }
+
+private:
+    float current = 0.0f, target = 0.0f, step = 0.0f;
+    int countdown = 0, stepsToTarget = 0;
+};
@@ -0,0 +1,265 @@
+#include "SpectrumAnalyzer.h"
+
+// Thread unique pour tout le process, créé avec le premier affichage ouvert
+// et détruit avec le dernier : éditeurs fermés, rien ne tourne en tâche de fond.
+struct SpectrumAnalyzer::AnalysisThread : public juce::Thread
+{
+    AnalysisThread() : juce::Thread("MerjEQ spectrum analyzer") { startThread(); }
+    ~AnalysisThread() override { stopThread(1000); }
+
+    void add(SpectrumAnalyzer* a)
+    {
+        const juce::ScopedLock sl(lock);
+        clients.addIfNotAlreadyThere(a);
+    }
+
+    void remove(SpectrumAnalyzer* a)
+    {
+        const juce::ScopedLock sl(lock);
+        clients.removeFirstMatchingValue(a);
+    }
+
+    void run() override
+    {
+        while (!threadShouldExit()) {
+            {
+                const juce::ScopedLock sl(lock);
+                for (auto* a : clients)
+                    a->service();
+            }
+            wait(5);
+        }
+    }
+
+    // Verrou partagé entre thread de message et thread d'analyse uniquement
+    juce::CriticalSection lock;
+    juce::Array<SpectrumAnalyzer*> clients;
+};
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+{
+    // Toute la mémoire est allouée ici : ni le thread audio ni l'analyse n'allouent
+    preFifo.assign((size_t) fifoSize, 0.0f);
+    postFifo.assign((size_t) fifoSize, 0.0f);
+    window.assign((size_t) fftSize, 0.0f);
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t) fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+    preHistory.assign((size_t) fftSize, 0.0f);
+    postHistory.assign((size_t) fftSize, 0.0f);
+    fftData.assign((size_t) fftSize * 2, 0.0f);
+    preAverage.assign((size_t) fftSize / 2 + 1, 0.0f);
+    postAverage.assign((size_t) fftSize / 2 + 1, 0.0f);
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    if (analysisThread.has_value())
+        (*analysisThread)->remove(this);
+}
+
+void SpectrumAnalyzer::prepare(double newSampleRate)
+{
+    sampleRate.store(newSampleRate);
+}
+
+template <typename SampleType>
+void SpectrumAnalyzer::pushPre(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+{
+    reserved = false;
+
+    // Éditeur fermé : la FIFO n'est pas vidée, on se contente d'un bloc de temps en temps
+    if (numViewers.load(std::memory_order_relaxed) == 0) {
+        closedBlockCounter = (closedBlockCounter + 1) % closedDecimation;
+        if (closedBlockCounter != 0)
+            return;
+    }
+
+    const int numSamples = buffer.getNumSamples();
+    if (numSamples == 0 || numChannels == 0 || fifo.getFreeSpace() < numSamples)
+        return;
+
+    fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+    writeDownmix(preFifo, buffer, numChannels);
+    reserved = true;
+}
+
+template <typename SampleType>
+void SpectrumAnalyzer::pushPost(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept
+{
+    if (!reserved)
+        return;
+
+    jassert(buffer.getNumSamples() == size1 + size2);
+    writeDownmix(postFifo, buffer, numChannels);
+    fifo.finishedWrite(size1 + size2);
+    reserved = false;
+}
+
+template <typename SampleType>
+void SpectrumAnalyzer::writeDownmix(std::vector<float>& dest, const juce::AudioBuffer<SampleType>& buffer, int numChannels) const noexcept
+{
+    const float gain = 1.0f / (float) numChannels;
+    auto mix = [&](int start, int size, int offset) {
+        if (size <= 0)
+            return;
+        auto* d = dest.data() + start;
+        if constexpr (std::is_same_v<SampleType, float>) {
+            juce::FloatVectorOperations::copyWithMultiply(d, buffer.getReadPointer(0, offset), gain, size);
+            for (int ch = 1; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::addWithMultiply(d, buffer.getReadPointer(ch, offset), gain, size);
+        } else {
+            // Double précision : somme en double, une seule conversion par échantillon
+            for (int i = 0; i < size; ++i) {
+                SampleType sum = 0;
+                for (int ch = 0; ch < numChannels; ++ch)
+                    sum += buffer.getReadPointer(ch, offset)[i];
+                d[i] = (float) sum * gain;
+            }
+        }
+    };
+    mix(start1, size1, 0);
+    mix(start2, size2, size1);
+}
+
+template void SpectrumAnalyzer::pushPre<float>(const juce::AudioBuffer<float>&, int) noexcept;
+template void SpectrumAnalyzer::pushPre<double>(const juce::AudioBuffer<double>&, int) noexcept;
+template void SpectrumAnalyzer::pushPost<float>(const juce::AudioBuffer<float>&, int) noexcept;
+template void SpectrumAnalyzer::pushPost<double>(const juce::AudioBuffer<double>&, int) noexcept;
+
+void SpectrumAnalyzer::addViewer()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    if (numViewers++ == 0) {
+        discardStale = true;
+        analysisThread.emplace();
+        (*analysisThread)->add(this);
+    }
+}
+
+void SpectrumAnalyzer::removeViewer()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    jassert(numViewers.load() > 0);
+    if (--numViewers == 0) {
+        (*analysisThread)->remove(this);
+        analysisThread.reset();
+    }
+}
+
+bool SpectrumAnalyzer::pullFrame(Frame& dest) noexcept
+{
+    if (!frames.pull())
+        return false;
+    dest = frames.getReadBuffer();
+    return true;
+}
+
+float SpectrumAnalyzer::frequencyOfPoint(int point) noexcept
+{
+    return minFrequency * std::pow(maxFrequency / minFrequency, (float) point / (float) (numPoints - 1));
+}
+
+void SpectrumAnalyzer::prepareBins(double rate)
+{
+    // Chaque point couvre les bins entre les milieux géométriques de ses voisins ;
+    // en bas du spectre, où un bin couvre plusieurs points, interpolation entre deux bins
+    const float binWidth = (float) (rate / fftSize);
+    const float halfStep = std::pow(maxFrequency / minFrequency, 0.5f / (float) (numPoints - 1));
+    const int lastBin = fftSize / 2;
+
+    for (int i = 0; i < numPoints; ++i) {
+        const float f = frequencyOfPoint(i);
+        auto& p = pointBins[(size_t) i];
+        p.first = juce::jlimit(0, lastBin, (int) std::ceil(f / halfStep / binWidth));
+        p.last = juce::jlimit(0, lastBin + 1, (int) std::floor(f * halfStep / binWidth) + 1);
+        p.frac = 0.0f;
+        if (p.last <= p.first) {
+            const float exact = juce::jlimit(0.0f, (float) (lastBin - 1), f / binWidth);
+            p.first = (int) exact;
+            p.last = p.first;
+            p.frac = exact - (float) p.first;
+        }
+    }
+
+    std::fill(preHistory.begin(), preHistory.end(), 0.0f);
+    std::fill(postHistory.begin(), postHistory.end(), 0.0f);
+    std::fill(preAverage.begin(), preAverage.end(), 0.0f);
+    std::fill(postAverage.begin(), postAverage.end(), 0.0f);
+    historyPos = 0;
+    samplesSinceFFT = 0;
+    binsSampleRate = rate;
+}
+
+void SpectrumAnalyzer::service()
+{
+    const double rate = sampleRate.load();
+    if (rate != binsSampleRate)
+        prepareBins(rate);
+
+    const int ready = fifo.getNumReady();
+    if (ready == 0)
+        return;
+
+    // Affichage qui s'ouvre : ce qui traîne dans la FIFO date de l'éditeur fermé
+    if (discardStale) {
+        fifo.finishedRead(ready);
+        discardStale = false;
+        return;
+    }
+
+    int s1, n1, s2, n2;
+    fifo.prepareToRead(ready, s1, n1, s2, n2);
+    auto append = [this](int start, int size) {
+        for (int i = 0; i < size; ++i) {
+            preHistory[(size_t) historyPos] = preFifo[(size_t) (start + i)];
+            postHistory[(size_t) historyPos] = postFifo[(size_t) (start + i)];
+            historyPos = (historyPos + 1) & (fftSize - 1);
+        }
+    };
+    append(s1, n1);
+    append(s2, n2);
+    fifo.finishedRead(n1 + n2);
+
+    // Une seule FFT pour tout ce qui est arrivé depuis la dernière : seule la plus récente s'affiche
+    samplesSinceFFT += n1 + n2;
+    if (samplesSinceFFT < hopSize)
+        return;
+
+    const float smoothing = (float) std::exp(-samplesSinceFFT / (averagingSeconds * rate));
+    samplesSinceFFT = 0;
+
+    auto& frame = frames.getWriteBuffer();
+    analyse(preHistory, preAverage, smoothing, frame.pre);
+    analyse(postHistory, postAverage, smoothing, frame.post);
+    frames.publish();
+}
+
+void SpectrumAnalyzer::analyse(const std::vector<float>& history, std::vector<float>& average, float smoothing,
+                               std::array<float, numPoints>& dest)
+{
+    // Historique circulaire remis dans l'ordre, du plus ancien au plus récent, fenêtré
+    for (int i = 0; i < fftSize; ++i)
+        fftData[(size_t) i] = history[(size_t) ((historyPos + i) & (fftSize - 1))] * window[(size_t) i];
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+    fft.performFrequencyOnlyForwardTransform(fftData.data(), true);
+
+    // Sinus pleine échelle : pic à fftSize / 4 avec la fenêtre de Hann (gain cohérent 0.5)
+    const float norm = 4.0f / (float) fftSize;
+    for (size_t k = 0; k < average.size(); ++k) {
+        const float magnitude = fftData[k] * norm;
+        average[k] = average[k] * smoothing + magnitude * magnitude * (1.0f - smoothing);
+    }
+
+    for (int i = 0; i < numPoints; ++i) {
+        const auto& p = pointBins[(size_t) i];
+        float power;
+        if (p.last > p.first) {
+            power = average[(size_t) p.first];
+            for (int k = p.first + 1; k < p.last; ++k)
+                power = juce::jmax(power, average[(size_t) k]);
+        } else {
+            power = average[(size_t) p.first] + p.frac * (average[(size_t) p.first + 1] - average[(size_t) p.first]);
+        }
+        dest[(size_t) i] = 10.0f * std::log10(juce::jmax(power, 1.0e-12f));
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <optional>
+#include <vector>
+#include "TripleBuffer.h"
+
+// Analyseur de spectre avant/après EQ.
+// Thread audio : downmix mono des deux points de mesure copié dans une FIFO
+// mono-producteur / mono-consommateur (juce::AbstractFifo), sans verrou ni allocation ;
+// bloc ignoré si la FIFO est pleine. Éditeur fermé : un bloc sur closedDecimation.
+// FFT, fenêtrage, moyennage et regroupement en fréquence log se font sur un thread
+// partagé par toutes les instances, qui n'existe que tant qu'un affichage est ouvert.
+// Les courbes sont publiées dans un triple buffer lu par l'éditeur.
+class SpectrumAnalyzer
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 8;
+    static constexpr int numPoints = 256;                 // points log entre minFrequency et maxFrequency
+    static constexpr float minFrequency = 20.0f, maxFrequency = 20000.0f;
+    static constexpr float averagingSeconds = 0.12f;
+    static constexpr int closedDecimation = 16;
+
+    // Niveaux en dB (0 dB = sinus pleine échelle)
+    struct Frame
+    {
+        std::array<float, numPoints> pre {}, post {};
+    };
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer();
+
+    // Audio arrêté
+    void prepare(double sampleRate);
+
+    // Thread audio : pushPre() avant l'EQ, pushPost() sur le même bloc après la saturation
+    // (float ou double ; l'analyse elle-même reste en float)
+    template <typename SampleType>
+    void pushPre(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept;
+    template <typename SampleType>
+    void pushPost(const juce::AudioBuffer<SampleType>& buffer, int numChannels) noexcept;
+
+    // Thread de message : affichages ouverts (démarrent / arrêtent l'analyse)
+    void addViewer();
+    void removeViewer();
+
+    // Thread de message : true si une nouvelle frame a été récupérée
+    bool pullFrame(Frame& dest) noexcept;
+
+    static float frequencyOfPoint(int point) noexcept;
+
+    // Appelé par le thread d'analyse partagé
+    void service();
+
+private:
+    template <typename SampleType>
+    void writeDownmix(std::vector<float>& dest, const juce::AudioBuffer<SampleType>& buffer, int numChannels) const noexcept;
+    void prepareBins(double sampleRate);
+    void analyse(const std::vector<float>& history, std::vector<float>& average, float smoothing,
+                 std::array<float, numPoints>& dest);
+
+    // === FIFO audio -> analyse ===
+    static constexpr int fifoSize = 1 << 15;
+    juce::AbstractFifo fifo { fifoSize };
+    std::vector<float> preFifo, postFifo;
+    int start1 = 0, size1 = 0, start2 = 0, size2 = 0;   // zone réservée entre pushPre et pushPost
+    bool reserved = false;
+    int closedBlockCounter = 0;
+    std::atomic<int> numViewers { 0 };
+    std::atomic<double> sampleRate { 44100.0 };
+
+    // === Thread d'analyse uniquement ===
+    juce::dsp::FFT fft { fftOrder };
+    std::vector<float> window, preHistory, postHistory, fftData, preAverage, postAverage;
+    int historyPos = 0, samplesSinceFFT = 0;
+    double binsSampleRate = 0.0;
+    struct PointBins { int first = 0, last = 0; float frac = 0.0f; };
+    std::array<PointBins, numPoints> pointBins;
+    bool discardStale = true;
+
+    TripleBuffer<Frame> frames;
+
+    struct AnalysisThread;
+    std::optional<juce::SharedResourcePointer<AnalysisThread>> analysisThread;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzer)
+};
@@ -0,0 +1,62 @@
+#include "SpectrumDisplay.h"
+
+SpectrumDisplay::SpectrumDisplay(SpectrumAnalyzer& a)
+    : analyzer(a)
+{
+    setOpaque(false);
+    setInterceptsMouseClicks(false, false);
+    frame.pre.fill(minDb);
+    frame.post.fill(minDb);
+    analyzer.addViewer();
+}
+
+SpectrumDisplay::~SpectrumDisplay()
+{
+    analyzer.removeViewer();
+}
+
+void SpectrumDisplay::pullFrame()
+{
+    if (analyzer.pullFrame(frame)) {
+        updatePaths();
+        repaint();
+    }
+}
+
+void SpectrumDisplay::resized()
+{
+    // Abscisses fixes : les points de l'analyseur sont déjà répartis en log
+    const float width = (float) getWidth();
+    for (int i = 0; i < SpectrumAnalyzer::numPoints; ++i)
+        pointX[(size_t) i] = width * (float) i / (float) (SpectrumAnalyzer::numPoints - 1);
+    updatePaths();
+}
+
+void SpectrumDisplay::updatePaths()
+{
+    const float height = (float) getHeight();
+    auto yFor = [height](float db) {
+        return juce::jmap(juce::jlimit(minDb, maxDb, db), minDb, maxDb, height, 0.0f);
+    };
+
+    prePath.clear();
+    postPath.clear();
+    prePath.startNewSubPath(0.0f, height);
+    for (int i = 0; i < SpectrumAnalyzer::numPoints; ++i) {
+        prePath.lineTo(pointX[(size_t) i], yFor(frame.pre[(size_t) i]));
+        if (i == 0)
+            postPath.startNewSubPath(pointX[0], yFor(frame.post[0]));
+        else
+            postPath.lineTo(pointX[(size_t) i], yFor(frame.post[(size_t) i]));
+    }
+    prePath.lineTo((float) getWidth(), height);
+    prePath.closeSubPath();
+}
+
+void SpectrumDisplay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colour::fromRGB(192, 192, 192).withAlpha(0.18f)); // argenté
+    g.fillPath(prePath);
+    g.setColour(juce::Colour::fromRGB(210, 122, 196).withAlpha(0.85f)); // rose MerjEQ
+    g.strokePath(postPath, juce::PathStrokeType(1.5f));
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <JuceHeader.h>
+#include "SpectrumAnalyzer.h"
+
+// Courbes avant EQ (gris, rempli) et après EQ (rose) de SpectrumAnalyzer.
+// Les frames sont récupérées au rythme de l'écran (VBlankAttachment) et le
+// composant n'est invalidé que si une nouvelle frame est arrivée.
+class SpectrumDisplay : public juce::Component
+{
+public:
+    explicit SpectrumDisplay(SpectrumAnalyzer& analyzer);
+    ~SpectrumDisplay() override;
+
+    void paint(juce::Graphics&) override;
+    void resized() override;
+
+private:
+    static constexpr float minDb = -78.0f, maxDb = 6.0f;
+
+    void pullFrame();
+    void updatePaths();
+
+    SpectrumAnalyzer& analyzer;
+    SpectrumAnalyzer::Frame frame;
+    std::array<float, SpectrumAnalyzer::numPoints> pointX {};
+    juce::Path prePath, postPath;
+
+    juce::VBlankAttachment vBlankAttachment { this, [this] { pullFrame(); } };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumDisplay)
+};
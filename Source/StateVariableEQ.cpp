@@ -0,0 +1,195 @@
+#include "StateVariableEQ.h"
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    constexpr double smoothingSeconds = 0.02;
+}
+
+// Incréments nuls (les valeurs par défaut de Coeffs sont celles d'une bande neutre)
+template <typename SampleType>
+const typename StateVariableEQ<SampleType>::Coeffs StateVariableEQ<SampleType>::noDelta { 0, 0, 0, 0, 0, 0 };
+
+template <typename SampleType>
+StateVariableEQ<SampleType>::StateVariableEQ()
+{
+    midQ.setCurrentAndTargetValue(1.0f);
+    groups.resize(1);
+    reset();
+}
+
+template <typename SampleType>
+void StateVariableEQ<SampleType>::prepare(double newSampleRate, int numChannels)
+{
+    sampleRate = newSampleRate;
+    groups.resize((size_t) ((std::max(1, numChannels) + groupSize - 1) / groupSize));
+    lowGain.reset(sampleRate, smoothingSeconds);
+    midGain.reset(sampleRate, smoothingSeconds);
+    highGain.reset(sampleRate, smoothingSeconds);
+    midQ.reset(sampleRate, smoothingSeconds);
+    snapToTargets();
+    reset();
+}
+
+template <typename SampleType>
+void StateVariableEQ<SampleType>::reset()
+{
+    for (auto& g : groups)
+        for (auto& s : g) {
+            s.ic1eq = Vec::expand((SampleType) 0);
+            s.ic2eq = Vec::expand((SampleType) 0);
+        }
+}
+
+template <typename SampleType>
+void StateVariableEQ<SampleType>::setParameters(const EQParameters& p)
+{
+    if (p.lowGain != lowGain.getTargetValue())   { lowGain.setTargetValue(p.lowGain); needsDesign = true; }
+    if (p.midGain != midGain.getTargetValue())   { midGain.setTargetValue(p.midGain); needsDesign = true; }
+    if (p.highGain != highGain.getTargetValue()) { highGain.setTargetValue(p.highGain); needsDesign = true; }
+    if (p.midQ != midQ.getTargetValue())         { midQ.setTargetValue(p.midQ); needsDesign = true; }
+}
+
+template <typename SampleType>
+bool StateVariableEQ<SampleType>::isNeutral() const noexcept
+{
+    return lowGain.getTargetValue() == 0.0f && midGain.getTargetValue() == 0.0f && highGain.getTargetValue() == 0.0f
+        && !lowGain.isSmoothing() && !midGain.isSmoothing() && !highGain.isSmoothing() && !needsDesign;
+}
+
+template <typename SampleType>
+typename StateVariableEQ<SampleType>::Coeffs StateVariableEQ<SampleType>::design(int band, double rate, float gainDb, float q) noexcept
+{
+    const auto d = EQDesign::makeStateVariable(band, EQDesign::prewarp(band, rate), gainDb, q);
+    return { (SampleType) d.a1, (SampleType) d.a2, (SampleType) d.a3,
+             (SampleType) d.m0, (SampleType) d.m1, (SampleType) d.m2 };
+}
+
+template <typename SampleType>
+void StateVariableEQ<SampleType>::snapToTargets() noexcept
+{
+    lowGain.setCurrentAndTargetValue(lowGain.getTargetValue());
+    midGain.setCurrentAndTargetValue(midGain.getTargetValue());
+    highGain.setCurrentAndTargetValue(highGain.getTargetValue());
+    midQ.setCurrentAndTargetValue(midQ.getTargetValue());
+
+    const float gains[] = { lowGain.getTargetValue(), midGain.getTargetValue(), highGain.getTargetValue() };
+    for (int b = 0; b < EQBands::numBands; ++b) {
+        auto& band = bands[(size_t) b];
+        band.target = design(b, sampleRate, gains[b], b == EQBands::mid ? midQ.getTargetValue() : EQBands::shelfQ);
+        band.current = band.target;
+        band.delta = noDelta;
+    }
+    samplesUntilUpdate = 0;
+    needsDesign = false;
+}
+
+template <typename SampleType>
+void StateVariableEQ<SampleType>::updateControl() noexcept
+{
+    // On repart exactement de la cible précédente (pas de dérive d'interpolation)
+    for (auto& band : bands) {
+        band.current = band.target;
+        band.delta = noDelta;
+    }
+
+    const bool smoothing = lowGain.isSmoothing() || midGain.isSmoothing() || highGain.isSmoothing() || midQ.isSmoothing();
+    if (!smoothing && !needsDesign)
+        return;
+    needsDesign = false;
+
+    const float gains[] = { lowGain.skip(controlInterval), midGain.skip(controlInterval), highGain.skip(controlInterval) };
+    const float q = midQ.skip(controlInterval);
+    const SampleType step = (SampleType) 1 / (SampleType) controlInterval;
+
+    for (int b = 0; b < EQBands::numBands; ++b) {
+        auto& band = bands[(size_t) b];
+        band.target = design(b, sampleRate, gains[b], b == EQBands::mid ? q : EQBands::shelfQ);
+        band.delta.a1 = (band.target.a1 - band.current.a1) * step;
+        band.delta.a2 = (band.target.a2 - band.current.a2) * step;
+        band.delta.a3 = (band.target.a3 - band.current.a3) * step;
+        band.delta.m0 = (band.target.m0 - band.current.m0) * step;
+        band.delta.m1 = (band.target.m1 - band.current.m1) * step;
+        band.delta.m2 = (band.target.m2 - band.current.m2) * step;
+    }
+}
+
+template <typename SampleType>
+void StateVariableEQ<SampleType>::process(SampleType* const* channels, int numChannels, int numSamples)
+{
+    assert(numChannels <= (int) groups.size() * groupSize);
+    numChannels = std::min(numChannels, (int) groups.size() * groupSize);
+
+    int pos = 0;
+    while (pos < numSamples) {
+        if (samplesUntilUpdate == 0) {
+            updateControl();
+            samplesUntilUpdate = controlInterval;
+        }
+        const int n = std::min(samplesUntilUpdate, numSamples - pos);
+        processSegment(channels, numChannels, pos, n);
+        pos += n;
+        samplesUntilUpdate -= n;
+    }
+}
+
+template <typename SampleType>
+void StateVariableEQ<SampleType>::processSegment(SampleType* const* channels, int numChannels, int start, int numSamples) noexcept
+{
+    // Chaque groupe part des mêmes coefficients et les interpole à l'identique ;
+    // on garde ceux atteints en fin de segment.
+    BandCoeffs end;
+    for (size_t b = 0; b < bands.size(); ++b)
+        end[b] = bands[b].current;
+
+    for (int first = 0, g = 0; first < numChannels; first += groupSize, ++g)
+        end = processGroup(groups[(size_t) g], channels + first, std::min(groupSize, numChannels - first), start, numSamples);
+
+    for (size_t b = 0; b < bands.size(); ++b)
+        bands[b].current = end[b];
+}
+
+template <typename SampleType>
+typename StateVariableEQ<SampleType>::BandCoeffs StateVariableEQ<SampleType>::processGroup(GroupState& state, SampleType* const* channels,
+                                                                                               int numChannels, int start, int numSamples) const noexcept
+{
+    BandCoeffs coeffs;
+    for (size_t b = 0; b < bands.size(); ++b)
+        coeffs[b] = bands[b].current;
+
+    auto st = state;
+    alignas(16 * sizeof(float)) SampleType frame[Vec::SIMDNumElements] = {};
+    const auto two = Vec::expand((SampleType) 2);
+
+    for (int i = start; i < start + numSamples; ++i) {
+        for (int ch = 0; ch < numChannels; ++ch)
+            frame[ch] = channels[ch][i];
+
+        auto x = Vec::fromRawArray(frame);
+        for (size_t b = 0; b < bands.size(); ++b) {
+            auto& c = coeffs[b];
+            auto& s = st[b];
+            const auto& d = bands[b].delta;
+            const auto v3 = x - s.ic2eq;
+            const auto v1 = Vec::expand(c.a1) * s.ic1eq + Vec::expand(c.a2) * v3;
+            const auto v2 = s.ic2eq + Vec::expand(c.a2) * s.ic1eq + Vec::expand(c.a3) * v3;
+            s.ic1eq = two * v1 - s.ic1eq;
+            s.ic2eq = two * v2 - s.ic2eq;
+            x = Vec::expand(c.m0) * x + Vec::expand(c.m1) * v1 + Vec::expand(c.m2) * v2;
+
+            c.a1 += d.a1; c.a2 += d.a2; c.a3 += d.a3;
+            c.m0 += d.m0; c.m1 += d.m1; c.m2 += d.m2;
+        }
+        x.copyToRawArray(frame);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+            channels[ch][i] = frame[ch];
+    }
+
+    state = st;
+    return coeffs;
+}
+
+template class StateVariableEQ<float>;
+template class StateVariableEQ<double>;
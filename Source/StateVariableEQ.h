@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "EQCoefficients.h"
+#include "SmoothedParameter.h"
+
+// Moteur alternatif : 3 SVF topology-preserving (Simper/Zavalishin) pour
+// low shelf 200 Hz, peak 4 kHz et high shelf 12 kHz.
+// Les paramètres sont lissés ; les coefficients sont recalculés tous les
+// controlInterval échantillons puis interpolés linéairement entre deux mises à jour.
+// Contrairement au biquad forme directe en float, l'état reste précis à basse
+// fréquence et à haute fréquence d'échantillonnage.
+// Canaux traités par groupes de groupSize (un canal par lane SIMD), comme BiquadCascade.
+template <typename SampleType>
+class StateVariableEQ
+{
+public:
+    using Vec = SIMDVector<SampleType>;
+    static constexpr int groupSize = (int) Vec::SIMDNumElements;
+    static constexpr int controlInterval = 32;
+
+    StateVariableEQ();
+
+    // Alloue l'état pour numChannels canaux (hors thread audio)
+    void prepare(double sampleRate, int numChannels);
+    void reset();
+
+    // Nouvelles cibles (gains en dB) : le lissage se fait dans process()
+    void setParameters(const EQParameters& params);
+
+    // Gains à 0 dB et lissage terminé : les trois bandes laissent passer le signal tel quel
+    bool isNeutral() const noexcept;
+
+    void process(SampleType* const* channels, int numChannels, int numSamples);
+
+private:
+    struct Coeffs
+    {
+        SampleType a1 = 1, a2 = 0, a3 = 0;
+        SampleType m0 = 1, m1 = 0, m2 = 0;
+    };
+
+    static const Coeffs noDelta;
+
+    struct Band
+    {
+        Coeffs current, target, delta;
+    };
+
+    struct State
+    {
+        Vec ic1eq, ic2eq;
+    };
+
+    using GroupState = std::array<State, EQBands::numBands>;
+    using BandCoeffs = std::array<Coeffs, EQBands::numBands>;
+
+    static Coeffs design(int band, double sampleRate, float gainDb, float q) noexcept;
+    void updateControl() noexcept;
+    void snapToTargets() noexcept;
+    void processSegment(SampleType* const* channels, int numChannels, int start, int numSamples) noexcept;
+    BandCoeffs processGroup(GroupState& state, SampleType* const* channels, int numChannels, int start, int numSamples) const noexcept;
+
+    std::array<Band, EQBands::numBands> bands;
+    std::vector<GroupState> groups;
+    SmoothedParameter<> lowGain, midGain, highGain;
+    SmoothedParameter<SmoothingType::multiplicative> midQ;
+    double sampleRate = 44100.0;
+    int samplesUntilUpdate = 0;
+    bool needsDesign = true;
+};
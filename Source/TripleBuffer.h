@@ -0,0 +1,55 @@
+#pragma once
+#include <array>
+#include <atomic>
+
+// Triple buffer sans verrou, un seul producteur et un seul consommateur.
+// Le producteur écrit dans son slot puis publish() ; le consommateur appelle
+// pull() et lit getReadBuffer(). Aucun des deux ne bloque ni n'alloue.
+template <typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer() = default;
+
+    // Côté producteur
+    T& getWriteBuffer() noexcept { return slots[(size_t) writeIndex]; }
+
+    void publish() noexcept
+    {
+        auto previous = middle.exchange(writeIndex | newDataBit, std::memory_order_acq_rel);
+        writeIndex = previous & indexMask;
+    }
+
+    // Côté consommateur : true si un nouveau contenu a été récupéré
+    bool pull() noexcept
+    {
+        if ((middle.load(std::memory_order_relaxed) & newDataBit) == 0)
+            return false;
+
+        auto previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & indexMask;
+        return true;
+    }
+
+    const T& getReadBuffer() const noexcept { return slots[(size_t) readIndex]; }
+
+    // Ni producteur ni consommateur actifs (prepare) : les trois slots prennent value
+    // (dimensionnement des contenus alloués) et rien n'est en attente
+    void resetAll(const T& value)
+    {
+        for (auto& s : slots)
+            s = value;
+        middle.store(1);
+        writeIndex = 0;
+        readIndex = 2;
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newDataBit = 4;
+
+    std::array<T, 3> slots {};
+    std::atomic<int> middle { 1 };
+    int writeIndex = 0;
+    int readIndex = 2;
+};
@@ -0,0 +1,236 @@
+#include "VocalAnalysis.h"
+
+namespace
+{
+    // Courbe cible (dB, tiers d'octave de 63 Hz à 16 kHz) : spectre moyen de la voix,
+    // plat de 125 à 300 Hz puis environ -3 dB/octave, air qui retombe au-dessus de 10 kHz
+    constexpr std::array<float, VocalProfile::numBands> targetDb {
+        -14.0f, -8.0f, -4.0f, -1.0f, 0.0f, 0.0f, 0.0f, -0.5f, -1.0f, -2.0f,      // 63 Hz - 500 Hz
+        -3.5f, -5.0f, -6.0f, -7.0f, -8.0f, -9.0f, -10.0f, -11.0f, -12.0f,        // 630 Hz - 4 kHz
+        -13.0f, -14.0f, -15.5f, -17.5f, -20.0f, -24.0f                           // 5 kHz - 16 kHz
+    };
+
+    // Référence du niveau : le corps de la voix, 250 Hz - 2 kHz
+    constexpr int referenceFirst = 6, referenceLast = 15;
+    // Zones couvertes par chaque bande de l'EQ
+    constexpr int lowFirst = 2, lowLast = 5;            // 100 - 200 Hz, sous le shelf à 200 Hz
+    constexpr int midFirst = 16, midLast = 20;          // 2.5 - 6.3 kHz, autour du peak à 4 kHz
+    constexpr int midCentre = 18;
+    constexpr int highFirst = 23, highLast = 24;        // 12.5 - 16 kHz, au-dessus du shelf à 12 kHz
+
+    // Voix retenue : au-dessus de -60 dB FS et à moins de 30 dB des trames fortes
+    constexpr int minimumLevel = 40;
+    constexpr int gateRangeDb = 30;
+    constexpr double minimumSeconds = 1.0;
+
+    constexpr float correction = 2.0f / 3.0f;
+    constexpr float maxBoostDb = 6.0f;
+
+    float roundTo(float value, float step) noexcept { return std::round(value / step) * step + 0.0f; }   // sans -0
+
+    // Niveau (case) sous lequel se trouve la fraction donnée de la durée
+    int percentileLevel(const std::array<double, VocalProfile::numLevels>& seconds, int firstLevel, double fraction) noexcept
+    {
+        double total = 0.0;
+        for (int l = firstLevel; l < VocalProfile::numLevels; ++l)
+            total += seconds[(size_t) l];
+        double cumulated = 0.0;
+        for (int l = firstLevel; l < VocalProfile::numLevels; ++l) {
+            cumulated += seconds[(size_t) l];
+            if (cumulated >= fraction * total)
+                return l;
+        }
+        return VocalProfile::numLevels - 1;
+    }
+}
+
+void VocalProfile::add(const VocalProfile& other) noexcept
+{
+    for (size_t l = 0; l < (size_t) numLevels; ++l) {
+        seconds[l] += other.seconds[l];
+        for (size_t b = 0; b < (size_t) numBands; ++b)
+            bandPower[l][b] += other.bandPower[l][b];
+    }
+}
+
+double VocalProfile::getTotalSeconds() const noexcept
+{
+    double total = 0.0;
+    for (auto s : seconds)
+        total += s;
+    return total;
+}
+
+VocalAnalyser::VocalAnalyser(double rate, int channels)
+    : sampleRate(rate), numChannels(juce::jlimit(1, 2, channels)),
+      frame(numChannels, fftSize), window((size_t) fftSize), fftBuffer((size_t) (2 * fftSize))
+{
+    juce::dsp::WindowingFunction<float>::fillWindowingTables(window.data(), (size_t) fftSize,
+                                                             juce::dsp::WindowingFunction<float>::hann, false);
+    double windowEnergy = 0.0;
+    for (auto w : window)
+        windowEnergy += (double) w * w;
+    // Somme des |X|² d'une bande / (N x énergie de la fenêtre) : puissance de la bande
+    // rapportée à la fréquence d'échantillonnage, comparable d'une fréquence à l'autre
+    powerScale = 1.0 / ((double) fftSize * windowEnergy * (double) numChannels);
+
+    const double binHz = sampleRate / fftSize;
+    const int lastBin = fftSize / 2;
+    for (int b = 0; b < VocalProfile::numBands; ++b) {
+        const double centre = VocalProfile::bandFrequency(b);
+        const int first = (int) std::ceil(centre * std::exp2(-1.0 / 6.0) / binHz);
+        int last = juce::jmin(lastBin + 1, (int) std::ceil(centre * std::exp2(1.0 / 6.0) / binHz));
+        // Bandes graves plus étroites qu'un bin : au moins le bin du centre
+        if (last <= first && first <= lastBin)
+            last = first + 1;
+        bandBins[(size_t) b] = first <= lastBin ? std::make_pair(first, last) : std::make_pair(0, 0);
+    }
+}
+
+juce::int64 VocalAnalyser::getNumFrames(juce::int64 numSamples) noexcept
+{
+    return numSamples <= 0 ? 0 : (numSamples + hopSize - 1) / hopSize;
+}
+
+bool VocalAnalyser::analyseFrames(juce::AudioFormatReader& reader, juce::int64 firstFrame, juce::int64 numFrames,
+                                  VocalProfile& dest, const std::function<bool()>& shouldStop)
+{
+    // Première trame lue en entier, puis un demi-bloc par trame
+    if (!reader.read(&frame, 0, fftSize, firstFrame * hopSize, true, numChannels > 1))
+        return false;
+
+    for (juce::int64 f = 0; f < numFrames; ++f) {
+        if (shouldStop && shouldStop())
+            return false;
+        if (f > 0) {
+            for (int ch = 0; ch < numChannels; ++ch) {
+                auto* data = frame.getWritePointer(ch);
+                std::copy(data + hopSize, data + fftSize, data);
+            }
+            const auto start = (firstFrame + f) * hopSize + hopSize;
+            if (!reader.read(&frame, hopSize, hopSize, start, true, numChannels > 1))
+                return false;
+        }
+        analyseFrame(dest);
+    }
+    return true;
+}
+
+void VocalAnalyser::analyseFrame(VocalProfile& dest) noexcept
+{
+    // Niveau RMS de la trame (canaux confondus)
+    double energy = 0.0;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const auto* data = frame.getReadPointer(ch);
+        for (int i = 0; i < fftSize; ++i)
+            energy += (double) data[i] * data[i];
+    }
+    const double rms = std::sqrt(energy / (fftSize * numChannels));
+    const double levelDb = juce::Decibels::gainToDecibels(rms, -200.0);
+    const auto level = (size_t) juce::jlimit(0, VocalProfile::numLevels - 1, (int) std::floor(levelDb) + VocalProfile::numLevels);
+    const double seconds = hopSize / sampleRate;
+
+    dest.seconds[level] += seconds;
+    if (energy == 0.0)
+        return;
+
+    auto& bandPower = dest.bandPower[level];
+    for (int ch = 0; ch < numChannels; ++ch) {
+        const auto* data = frame.getReadPointer(ch);
+        for (int i = 0; i < fftSize; ++i)
+            fftBuffer[(size_t) i] = data[i] * window[(size_t) i];
+        fft.performFrequencyOnlyForwardTransform(fftBuffer.data(), true);
+
+        for (size_t b = 0; b < (size_t) VocalProfile::numBands; ++b) {
+            double sum = 0.0;
+            for (int k = bandBins[b].first; k < bandBins[b].second; ++k)
+                sum += (double) fftBuffer[(size_t) k] * fftBuffer[(size_t) k];
+            bandPower[b] += sum * powerScale * seconds;
+        }
+    }
+}
+
+VocalSuggestion VocalAnalyser::suggest(const VocalProfile& profile) noexcept
+{
+    VocalSuggestion s;
+
+    // Voix : trames au-dessus du plancher et à moins de gateRangeDb des plus fortes (95 %)
+    const int loud = percentileLevel(profile.seconds, minimumLevel, 0.95);
+    const int gate = juce::jmax(minimumLevel, loud - gateRangeDb);
+
+    std::array<double, VocalProfile::numBands> power {};
+    double seconds = 0.0;
+    for (int l = gate; l < VocalProfile::numLevels; ++l) {
+        seconds += profile.seconds[(size_t) l];
+        for (size_t b = 0; b < power.size(); ++b)
+            power[b] += profile.bandPower[(size_t) l][b];
+    }
+    s.activeSeconds = (float) seconds;
+    if (seconds < minimumSeconds)
+        return s;
+    s.loudnessRangeDb = (float) (loud - percentileLevel(profile.seconds, gate, 0.10));
+
+    // Écart à la cible, au niveau du corps de la voix ; bandes vides (au-delà de Nyquist) ignorées
+    std::array<float, VocalProfile::numBands> deviation {};
+    std::array<bool, VocalProfile::numBands> measured {};
+    for (size_t b = 0; b < power.size(); ++b) {
+        measured[b] = power[b] > 0.0;
+        if (measured[b])
+            deviation[b] = (float) (10.0 * std::log10(power[b] / seconds)) - targetDb[b];
+    }
+    float reference = 0.0f;
+    int numReference = 0;
+    for (int b = referenceFirst; b <= referenceLast; ++b)
+        if (measured[(size_t) b]) {
+            reference += deviation[(size_t) b];
+            ++numReference;
+        }
+    if (numReference == 0)
+        return s;
+    reference /= (float) numReference;
+    for (auto& d : deviation)
+        d -= reference;
+
+    // Écart moyen d'une zone, pondéré (bords de la zone à moitié)
+    auto zoneDeviation = [&](int first, int last) {
+        float sum = 0.0f, weights = 0.0f;
+        for (int b = first; b <= last; ++b) {
+            if (!measured[(size_t) b])
+                continue;
+            const float w = (b == first || b == last) && last > first + 1 ? 0.5f : 1.0f;
+            sum += w * deviation[(size_t) b];
+            weights += w;
+        }
+        return weights > 0.0f ? sum / weights : 0.0f;
+    };
+    auto gainFor = [](float dev) {
+        return roundTo(juce::jlimit(EQBands::minGainDb, maxBoostDb, -correction * dev), 0.5f);
+    };
+
+    s.eq.lowGain = gainFor(zoneDeviation(lowFirst, lowLast));
+    s.eq.highGain = gainFor(zoneDeviation(highFirst, highLast));
+    const float midDeviation = zoneDeviation(midFirst, midLast);
+    s.eq.midGain = gainFor(midDeviation);
+
+    // Q du peak : largeur (en tiers d'octave) de l'écart autour de 4 kHz, de même signe et
+    // d'au moins la moitié de l'écart moyen de la zone
+    s.eq.midQ = 1.0f;
+    if (std::abs(s.eq.midGain) >= 1.0f) {
+        auto isPartOfPeak = [&](int b) {
+            return measured[(size_t) b] && deviation[(size_t) b] * midDeviation > 0.0f
+                && std::abs(deviation[(size_t) b]) >= 0.5f * std::abs(midDeviation);
+        };
+        int width = isPartOfPeak(midCentre) ? 1 : 0;
+        if (width > 0) {
+            for (int b = midCentre - 1; b >= midCentre - 5 && isPartOfPeak(b); --b) ++width;
+            for (int b = midCentre + 1; b <= midCentre + 4 && b < VocalProfile::numBands && isPartOfPeak(b); ++b) ++width;
+        }
+        // Q = sqrt(2^N) / (2^N - 1) pour une largeur de N octaves
+        const float octaves = juce::jmax(1, width) / 3.0f;
+        const float ratio = std::exp2(octaves);
+        s.eq.midQ = roundTo(juce::jlimit(0.5f, 4.0f, std::sqrt(ratio) / (ratio - 1.0f)), 0.05f);
+    }
+
+    s.valid = true;
+    return s;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include <functional>
+#include <vector>
+#include "EQCoefficients.h"
+
+// Profil long terme d'une prise de voix : puissance par tiers d'octave (63 Hz - 16 kHz),
+// rangée par niveau de la trame (1 dB par case). Le niveau permet d'écarter les silences
+// et le bruit entre les phrases sans connaître à l'avance le niveau de la prise : des
+// morceaux analysés séparément (en parallèle, ou plusieurs prises) s'additionnent.
+// Durées et puissances ne dépendent pas de la fréquence d'échantillonnage.
+struct VocalProfile
+{
+    static constexpr int numBands = 25;        // tiers d'octave, 63 Hz (0) à 16 kHz (24), 1 kHz = 12
+    static constexpr int numLevels = 100;      // niveau RMS de la trame, case 0 = -100 dB FS
+
+    std::array<double, numLevels> seconds {};                              // durée par niveau
+    std::array<std::array<double, numBands>, numLevels> bandPower {};      // puissance x durée
+
+    void add(const VocalProfile& other) noexcept;
+    double getTotalSeconds() const noexcept;
+
+    static float bandFrequency(int band) noexcept { return 1000.0f * std::exp2((float) (band - 12) / 3.0f); }
+};
+
+// Point de départ proposé pour LowGain, MidGain, HighGain et MidQ
+struct VocalSuggestion
+{
+    EQParameters eq;
+    float activeSeconds = 0.0f;         // voix retenue (hors silences)
+    float loudnessRangeDb = 0.0f;       // trames fortes (95 %) - trames faibles (10 %) de la voix
+    bool valid = false;
+
+    bool operator==(const VocalSuggestion& o) const noexcept
+    {
+        return valid == o.valid && eq.lowGain == o.eq.lowGain && eq.midGain == o.eq.midGain
+            && eq.highGain == o.eq.highGain && eq.midQ == o.eq.midQ;
+    }
+    bool operator!=(const VocalSuggestion& o) const noexcept { return !(*this == o); }
+};
+
+// Analyse par trames FFT (4096 points, recouvrement 50 %, Hann), canaux moyennés en puissance.
+// Un analyseur par thread : des plages de trames disjointes s'analysent en parallèle avec
+// des analyseurs et des lecteurs distincts.
+class VocalAnalyser
+{
+public:
+    static constexpr int fftOrder = 12;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+
+    VocalAnalyser(double sampleRate, int numChannels);
+
+    static juce::int64 getNumFrames(juce::int64 numSamples) noexcept;
+
+    // Ajoute à dest les trames [firstFrame, firstFrame + numFrames) lues dans reader
+    // (au-delà de la fin : zéros). false si la lecture échoue ou si shouldStop() le demande.
+    bool analyseFrames(juce::AudioFormatReader& reader, juce::int64 firstFrame, juce::int64 numFrames,
+                       VocalProfile& dest, const std::function<bool()>& shouldStop);
+
+    // Écart du profil à une courbe cible de voix (spectre moyen de la parole, au tiers
+    // d'octave), corrigé aux deux tiers et arrondi : un point de départ, pas un appariement.
+    // Thread quelconque ; valid == false sous une seconde de voix.
+    static VocalSuggestion suggest(const VocalProfile& profile) noexcept;
+
+private:
+    void analyseFrame(VocalProfile& dest) noexcept;
+
+    double sampleRate;
+    int numChannels;
+    juce::dsp::FFT fft { fftOrder };
+    juce::AudioBuffer<float> frame;           // fftSize échantillons par canal
+    std::vector<float> window, fftBuffer;
+    double powerScale = 1.0;                  // puissance par bande indépendante de la fréquence
+    std::array<std::pair<int, int>, VocalProfile::numBands> bandBins {};   // [début, fin)
+};
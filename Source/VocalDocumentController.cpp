@@ -0,0 +1,258 @@
+#include "VocalDocumentController.h"
+
+#if JucePlugin_Enable_ARA
+#include <atomic>
+#include "RegionPlaybackRenderer.h"
+
+namespace
+{
+    constexpr double chunkSeconds = 10.0;       // morceau de prise confié à un thread à la fois
+    constexpr int maxAnalysisThreads = 4;       // par prise : 40 prises se partagent le pool
+    constexpr int archiveVersion = 1;
+}
+
+// Une analyse en cours : les threads tirent les morceaux dans l'ordre (compteur atomique),
+// chacun avec son lecteur et son profil partiel ; le dernier qui termine additionne les partiels.
+struct VocalAudioSource::Analysis
+{
+    struct Worker : public juce::ThreadPoolJob
+    {
+        Worker(Analysis& a, int i) : juce::ThreadPoolJob("MerjEQ vocal analysis"), analysis(a), index(i) {}
+
+        JobStatus runJob() override
+        {
+            analysis.run(index, [this] { return shouldExit(); });
+            return jobHasFinished;
+        }
+
+        Analysis& analysis;
+        const int index;
+    };
+
+    Analysis(VocalAudioSource& source, int numThreads)
+        : owner(source),
+          numFrames(VocalAnalyser::getNumFrames(source.getSampleCount())),
+          framesPerChunk(juce::jmax((juce::int64) 1, (juce::int64) std::ceil(chunkSeconds * source.getSampleRate() / VocalAnalyser::hopSize))),
+          numChunks((numFrames + framesPerChunk - 1) / framesPerChunk)
+    {
+        numThreads = (int) juce::jlimit((juce::int64) 1, (juce::int64) numThreads, juce::jmax((juce::int64) 1, numChunks));
+        partials.resize((size_t) numThreads);
+        for (int i = 0; i < numThreads; ++i) {
+            // Lecteurs créés (et détruits) sur le thread de message : ils écoutent la source
+            readers.push_back(std::make_unique<juce::ARAAudioSourceReader>(&source));
+            workers.push_back(std::make_unique<Worker>(*this, i));
+        }
+        remaining.store(numThreads);
+    }
+
+    void run(int index, const std::function<bool()>& shouldStop)
+    {
+        VocalAnalyser analyser(owner.getSampleRate(), owner.getChannelCount());
+        auto& reader = *readers[(size_t) index];
+
+        for (auto chunk = nextChunk++; chunk < numChunks && !failed; chunk = nextChunk++) {
+            const auto first = chunk * framesPerChunk;
+            if (!reader.isValid()
+                || !analyser.analyseFrames(reader, first, juce::jmin(framesPerChunk, numFrames - first), partials[(size_t) index], shouldStop)) {
+                failed = true;
+                break;
+            }
+            owner.notifyAnalysisProgressUpdated((float) ++chunksDone / (float) numChunks);
+        }
+
+        if (--remaining > 0)
+            return;
+        if (!failed) {
+            VocalProfile merged;
+            for (const auto& p : partials)
+                merged.add(p);
+            owner.publish(merged);
+        }
+        owner.notifyAnalysisProgressCompleted();
+        finished = true;
+        owner.triggerAsyncUpdate();         // libère lecteurs et jobs sur le thread de message
+    }
+
+    VocalAudioSource& owner;
+    const juce::int64 numFrames, framesPerChunk, numChunks;
+    std::vector<std::unique_ptr<juce::ARAAudioSourceReader>> readers;
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<VocalProfile> partials;
+    std::atomic<juce::int64> nextChunk { 0 };
+    std::atomic<int> chunksDone { 0 }, remaining { 0 };
+    std::atomic<bool> failed { false }, finished { false };
+};
+
+VocalAudioSource::VocalAudioSource(juce::ARADocument* document, ARA::ARAAudioSourceHostRef hostRef)
+    : juce::ARAAudioSource(document, hostRef)
+{
+}
+
+VocalAudioSource::~VocalAudioSource()
+{
+    cancelAnalysis();
+}
+
+bool VocalAudioSource::getProfile(VocalProfile& dest) const
+{
+    const juce::SpinLock::ScopedLockType lock(profileLock);
+    if (profile == nullptr)
+        return false;
+    dest = *profile;
+    return true;
+}
+
+bool VocalAudioSource::hasProfile() const
+{
+    const juce::SpinLock::ScopedLockType lock(profileLock);
+    return profile != nullptr;
+}
+
+void VocalAudioSource::startAnalysis()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    cancelAnalysis();
+    if (!isSampleAccessEnabled() || getSampleCount() <= 0 || getSampleRate() <= 0.0)
+        return;
+
+    analysis = std::make_unique<Analysis>(*this, juce::jmin(maxAnalysisThreads, analysisPool->getNumThreads()));
+    notifyAnalysisProgressStarted();
+    for (auto& worker : analysis->workers)
+        analysisPool->addJob(worker.get(), false);
+}
+
+void VocalAudioSource::cancelAnalysis()
+{
+    JUCE_ASSERT_MESSAGE_THREAD
+    if (analysis == nullptr)
+        return;
+
+    for (auto& worker : analysis->workers)
+        analysisPool->removeJob(worker.get(), true, -1);
+    cancelPendingUpdate();
+    if (!analysis->finished)
+        notifyAnalysisProgressCompleted();
+    analysis.reset();
+}
+
+void VocalAudioSource::clearProfile()
+{
+    const juce::SpinLock::ScopedLockType lock(profileLock);
+    profile.reset();
+}
+
+void VocalAudioSource::restoreProfile(const VocalProfile& restored)
+{
+    cancelAnalysis();
+    publish(restored);
+}
+
+void VocalAudioSource::publish(const VocalProfile& result)
+{
+    auto copy = std::make_unique<VocalProfile>(result);
+    const juce::SpinLock::ScopedLockType lock(profileLock);
+    profile.swap(copy);
+}
+
+void VocalAudioSource::handleAsyncUpdate()
+{
+    if (analysis != nullptr && analysis->finished)
+        cancelAnalysis();
+}
+
+//==============================================================================
+juce::ARAAudioSource* VocalDocumentController::doCreateAudioSource(juce::ARADocument* document, ARA::ARAAudioSourceHostRef hostRef) noexcept
+{
+    auto* source = new VocalAudioSource(document, hostRef);
+    source->addListener(this);
+    return source;
+}
+
+juce::ARAPlaybackRenderer* VocalDocumentController::doCreatePlaybackRenderer() noexcept
+{
+    return new RegionPlaybackRenderer(getDocumentController());
+}
+
+void VocalDocumentController::didEnableAudioSourceSamplesAccess(juce::ARAAudioSource* source, bool enable)
+{
+    auto* vocal = static_cast<VocalAudioSource*>(source);
+    if (enable && !vocal->hasProfile())
+        vocal->startAnalysis();
+}
+
+void VocalDocumentController::willEnableAudioSourceSamplesAccess(juce::ARAAudioSource* source, bool enable)
+{
+    if (!enable)
+        static_cast<VocalAudioSource*>(source)->cancelAnalysis();
+}
+
+void VocalDocumentController::doUpdateAudioSourceContent(juce::ARAAudioSource* source, juce::ARAContentUpdateScopes scopeFlags)
+{
+    // Échantillons modifiés par l'hôte : le profil ne vaut plus rien
+    if (!scopeFlags.affectSamples())
+        return;
+    auto* vocal = static_cast<VocalAudioSource*>(source);
+    vocal->clearProfile();
+    vocal->startAnalysis();
+}
+
+void VocalDocumentController::willDestroyAudioSource(juce::ARAAudioSource* source)
+{
+    static_cast<VocalAudioSource*>(source)->cancelAnalysis();
+    source->removeListener(this);
+}
+
+// Archive : version, nombre de prises, puis par prise son identifiant et son profil
+bool VocalDocumentController::doStoreObjectsToStream(juce::ARAOutputStream& output, const juce::ARAStoreObjectsFilter* filter) noexcept
+{
+    std::vector<std::pair<juce::String, VocalProfile>> toStore;
+    for (auto* source : filter->getAudioSourcesToStore<VocalAudioSource>()) {
+        VocalProfile p;
+        if (source->getProfile(p))
+            toStore.emplace_back(juce::String(source->getPersistentID()), p);
+    }
+
+    if (!output.writeInt(archiveVersion) || !output.writeInt((int) toStore.size()))
+        return false;
+    for (const auto& [persistentID, p] : toStore) {
+        if (!output.writeString(persistentID))
+            return false;
+        for (size_t l = 0; l < (size_t) VocalProfile::numLevels; ++l) {
+            if (!output.writeFloat((float) p.seconds[l]))
+                return false;
+            for (auto power : p.bandPower[l])
+                if (!output.writeFloat((float) power))
+                    return false;
+        }
+    }
+    return true;
+}
+
+bool VocalDocumentController::doRestoreObjectsFromStream(juce::ARAInputStream& input, const juce::ARARestoreObjectsFilter* filter) noexcept
+{
+    // Archive d'une version plus récente : ignorée, les prises seront réanalysées
+    if (input.readInt() != archiveVersion)
+        return !input.failed();
+
+    const int numSources = input.readInt();
+    for (int i = 0; i < numSources && !input.failed(); ++i) {
+        const auto persistentID = input.readString();
+        VocalProfile p;
+        for (size_t l = 0; l < (size_t) VocalProfile::numLevels; ++l) {
+            p.seconds[l] = input.readFloat();
+            for (auto& power : p.bandPower[l])
+                power = input.readFloat();
+        }
+        if (input.failed())
+            break;
+        if (auto* source = filter->getAudioSourceToRestoreStateWith<VocalAudioSource>(persistentID.toRawUTF8()))
+            source->restoreProfile(p);
+    }
+    return !input.failed();
+}
+
+const ARA::ARAFactory* JUCE_CALLTYPE createARAFactory()
+{
+    return juce::ARADocumentControllerSpecialisation::createARAFactory<VocalDocumentController>();
+}
+#endif
@@ -0,0 +1,70 @@
+#pragma once
+#include <JuceHeader.h>
+
+#if JucePlugin_Enable_ARA
+#include <memory>
+#include "VocalAnalysis.h"
+
+// Threads d'analyse partagés par toutes les prises de tous les documents ARA, en priorité basse ;
+// vivent tant qu'une prise les référence
+struct VocalAnalysisPool : public juce::ThreadPool
+{
+    VocalAnalysisPool() : juce::ThreadPool(juce::jmax(1, juce::SystemStats::getNumCpus() - 1), 0, juce::Thread::Priority::low) {}
+};
+
+// Source audio ARA (une prise de la piste) et son profil vocal. L'analyse lit toute la prise
+// en tâche de fond, par morceaux répartis sur plusieurs threads (un lecteur ARA par thread),
+// dès que l'hôte autorise la lecture des échantillons ; le thread audio n'y touche jamais.
+class VocalAudioSource : public juce::ARAAudioSource,
+                         private juce::AsyncUpdater
+{
+public:
+    VocalAudioSource(juce::ARADocument* document, ARA::ARAAudioSourceHostRef hostRef);
+    ~VocalAudioSource() override;
+
+    // Thread quelconque : copie le dernier profil complet (false tant qu'il n'y en a pas)
+    bool getProfile(VocalProfile& dest) const;
+
+    // === Thread de message (contrôleur de document) ===
+    void startAnalysis();
+    void cancelAnalysis();
+    void clearProfile();
+    void restoreProfile(const VocalProfile& restored);
+    bool hasProfile() const;
+
+private:
+    struct Analysis;
+    void publish(const VocalProfile& result);
+    void handleAsyncUpdate() override;
+
+    juce::SharedResourcePointer<VocalAnalysisPool> analysisPool;
+    std::unique_ptr<Analysis> analysis;
+
+    mutable juce::SpinLock profileLock;
+    std::unique_ptr<VocalProfile> profile;      // sous profileLock
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VocalAudioSource)
+};
+
+// Contrôleur de document ARA : crée les prises analysées et le rendu des régions,
+// lance ou arrête l'analyse selon l'accès aux échantillons accordé par l'hôte,
+// et garde les profils dans le document de l'hôte (pas de nouvelle analyse à la réouverture).
+class VocalDocumentController : public juce::ARADocumentControllerSpecialisation,
+                                private juce::ARAAudioSource::Listener
+{
+public:
+    using juce::ARADocumentControllerSpecialisation::ARADocumentControllerSpecialisation;
+
+protected:
+    juce::ARAAudioSource* doCreateAudioSource(juce::ARADocument* document, ARA::ARAAudioSourceHostRef hostRef) noexcept override;
+    juce::ARAPlaybackRenderer* doCreatePlaybackRenderer() noexcept override;
+    bool doRestoreObjectsFromStream(juce::ARAInputStream& input, const juce::ARARestoreObjectsFilter* filter) noexcept override;
+    bool doStoreObjectsToStream(juce::ARAOutputStream& output, const juce::ARAStoreObjectsFilter* filter) noexcept override;
+
+private:
+    void didEnableAudioSourceSamplesAccess(juce::ARAAudioSource* source, bool enable) override;
+    void willEnableAudioSourceSamplesAccess(juce::ARAAudioSource* source, bool enable) override;
+    void doUpdateAudioSourceContent(juce::ARAAudioSource* source, juce::ARAContentUpdateScopes scopeFlags) override;
+    void willDestroyAudioSource(juce::ARAAudioSource* source) override;
+};
+#endif
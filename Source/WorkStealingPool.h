@@ -0,0 +1,90 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Quelques threads persistants qui exécutent, avec le thread appelant, des tâches
+// indépendantes (en rendu offline : une par partition de canaux du moteur).
+// Les tâches d'un run() sont réparties en plages contiguës, une par participant :
+// chacun dépile la sienne par le début puis, à court, vole par la fin des plages des autres.
+// run() n'alloue rien, peut être appelé par plusieurs threads à la fois (instances qui
+// partagent le pool) et ne rend la main qu'une fois toutes ses tâches finies.
+// Les workers tournent en FTZ/DAZ, comme un thread audio. Sans JUCE (bibliothèque MerjEQCore).
+class WorkStealingPool
+{
+public:
+    using Task = void (*)(void* context, int index);
+
+    static constexpr int maxWorkers = 7;
+
+    // Par défaut : un worker par cœur en plus de l'appelant, au plus maxWorkers
+    explicit WorkStealingPool(int numWorkers = defaultNumWorkers());
+    ~WorkStealingPool();
+
+    static int defaultNumWorkers() noexcept;
+    int getNumWorkers() const noexcept { return (int) threads.size(); }
+
+    // task(context, i) pour chaque i de [0, numTasks), le thread appelant compris
+    void run(int numTasks, Task task, void* context) noexcept;
+
+    // fn(i) pour chaque i de [0, numTasks) ; sans pool, à la suite sur le thread appelant
+    template <typename Function>
+    static void forEach(WorkStealingPool* pool, int numTasks, Function&& fn)
+    {
+        if (pool == nullptr || numTasks < 2) {
+            for (int i = 0; i < numTasks; ++i)
+                fn(i);
+            return;
+        }
+        using FunctionType = std::remove_reference_t<Function>;
+        pool->run(numTasks,
+                  [](void* context, int index) { (*static_cast<FunctionType*>(context))(index); },
+                  const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+    }
+
+private:
+    static constexpr int maxParticipants = maxWorkers + 1;   // l'appelant est le participant 0
+    static constexpr int maxJobs = 16;                        // run() simultanés, au-delà : à la suite
+
+    struct Job
+    {
+        Task task = nullptr;
+        void* context = nullptr;
+        int numRanges = 0;
+        std::array<std::atomic<uint64_t>, maxParticipants> ranges;   // début << 32 | fin
+        std::atomic<int> remaining { 0 };
+    };
+
+    // Job publié pour les workers ; users les compte pendant qu'ils le lisent, pour que
+    // run() (dont la pile porte le Job) ne rende la main qu'une fois le dernier sorti
+    struct Slot
+    {
+        std::atomic<bool> claimed { false };
+        std::atomic<Job*> job { nullptr };
+        std::atomic<int> users { 0 };
+    };
+
+    static bool popFront(std::atomic<uint64_t>& range, int& index) noexcept;
+    static bool popBack(std::atomic<uint64_t>& range, int& index) noexcept;
+    static bool work(Job& job, int participant) noexcept;
+    bool serviceSlots(int participant) noexcept;
+    void workerLoop(int participant);
+
+    std::array<Slot, maxJobs> slots;
+
+    std::mutex wakeLock;
+    std::condition_variable wake;
+    uint64_t generation = 0;      // incrémenté à chaque job publié (sous wakeLock)
+    bool stopping = false;
+
+    std::vector<std::thread> threads;
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+};
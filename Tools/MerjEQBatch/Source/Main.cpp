@@ -0,0 +1,281 @@
+/*
+  ==============================================================================
+
+    MerjEQBatch : rendu hors DAW de fichiers WAV/AIFF/FLAC à travers MerjEQ.
+
+    Usage : MerjEQBatch [options] <fichiers...>
+      --preset <fichier>       état sauvegardé par le plugin (getStateInformation)
+      --set <ParamID>=<valeur> valeur d'un paramètre, en unités réelles (répétable)
+      --out <dossier>          dossier de sortie (défaut, ou dossier de la source : à côté d'elle, suffixe _merjeq)
+      --threads <n>            nombre de workers (défaut : nombre de cœurs)
+      --block <n>              taille de bloc passée à processBlock (défaut 512)
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "../../../Source/PluginProcessor.h"
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    struct Options
+    {
+        juce::File preset;
+        juce::StringPairArray parameterValues;
+        juce::File outputDir;
+        int numThreads = juce::SystemStats::getNumCpus();
+        int blockSize = 512;
+        juce::Array<juce::File> inputs;
+    };
+
+    bool parseArgs(const juce::StringArray& args, Options& o)
+    {
+        for (int i = 0; i < args.size(); ++i) {
+            const auto& arg = args[i];
+            const bool hasValue = i + 1 < args.size();
+
+            if (arg == "--preset" && hasValue)        o.preset = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+            else if (arg == "--out" && hasValue)      o.outputDir = juce::File::getCurrentWorkingDirectory().getChildFile(args[++i]);
+            else if (arg == "--threads" && hasValue)  o.numThreads = juce::jmax(1, args[++i].getIntValue());
+            else if (arg == "--block" && hasValue)    o.blockSize = juce::jmax(1, args[++i].getIntValue());
+            else if (arg == "--set" && hasValue) {
+                const auto assignment = args[++i];
+                o.parameterValues.set(assignment.upToFirstOccurrenceOf("=", false, false),
+                                      assignment.fromFirstOccurrenceOf("=", false, false));
+            }
+            else if (arg.startsWith("--")) {
+                std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+                return false;
+            }
+            else
+                o.inputs.add(juce::File::getCurrentWorkingDirectory().getChildFile(arg));
+        }
+        return !o.inputs.isEmpty();
+    }
+
+    // Applique le preset puis les valeurs explicites ; false si un paramètre est inconnu
+    bool configure(MerjEQAudioProcessor& processor, const Options& o, const juce::MemoryBlock& presetData)
+    {
+        if (presetData.getSize() > 0)
+            processor.setStateInformation(presetData.getData(), (int) presetData.getSize());
+
+        for (auto& id : o.parameterValues.getAllKeys()) {
+            auto* param = processor.apvts.getParameter(id);
+            if (param == nullptr) {
+                std::cerr << "Unknown parameter: " << id << std::endl;
+                return false;
+            }
+            param->setValueNotifyingHost(param->convertTo0to1(o.parameterValues[id].getFloatValue()));
+        }
+        return true;
+    }
+
+    struct FileResult
+    {
+        juce::File file;
+        bool ok = false;
+        juce::String error;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;
+    };
+
+    // Un processeur par worker, créés sur le thread principal et empruntés par les jobs
+    class ProcessorPool
+    {
+    public:
+        void add(std::unique_ptr<MerjEQAudioProcessor> p) { free.add(p.get()); owned.push_back(std::move(p)); }
+
+        MerjEQAudioProcessor* acquire()
+        {
+            const juce::ScopedLock sl(lock);
+            return free.removeAndReturn(free.size() - 1);
+        }
+
+        void release(MerjEQAudioProcessor* p)
+        {
+            const juce::ScopedLock sl(lock);
+            free.add(p);
+        }
+
+    private:
+        juce::CriticalSection lock;
+        juce::Array<MerjEQAudioProcessor*> free;
+        std::vector<std::unique_ptr<MerjEQAudioProcessor>> owned;
+    };
+
+    // --out vers le dossier de la source : suffixe comme sans --out, la source n'est jamais écrasée
+    juce::File outputFileFor(const juce::File& input, const Options& o)
+    {
+        if (o.outputDir != juce::File() && o.outputDir.getChildFile(input.getFileName()) != input)
+            return o.outputDir.getChildFile(input.getFileName());
+        return input.getSiblingFile(input.getFileNameWithoutExtension() + "_merjeq" + input.getFileExtension());
+    }
+
+    // Lit, traite et écrit un fichier en streaming, latence du plugin compensée
+    FileResult renderFile(MerjEQAudioProcessor& processor, juce::AudioFormatManager& formats,
+                          const juce::File& input, const Options& o)
+    {
+        FileResult result;
+        result.file = input;
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+        if (reader == nullptr) {
+            result.error = "unreadable or unsupported format";
+            return result;
+        }
+
+        // Mono traité en stéréo (comportement historique), sinon le bus prend la largeur du fichier
+        const int fileChannels = (int) reader->numChannels;
+        const int numChannels = juce::jmax(2, fileChannels);
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        if (!processor.setBusesLayout(layout)) {
+            result.error = juce::String(fileChannels) + " channels is not supported";
+            return result;
+        }
+
+        // Une autre entrée (lue peut-être en ce moment par un autre worker) ne doit pas être effacée
+        auto outputFile = outputFileFor(input, o);
+        if (o.inputs.contains(outputFile)) {
+            result.error = "output " + outputFile.getFullPathName() + " is also an input file";
+            return result;
+        }
+        auto* format = formats.findFormatForFileExtension(outputFile.getFileExtension());
+        outputFile.deleteFile();
+        std::unique_ptr<juce::FileOutputStream> stream(outputFile.createOutputStream());
+        if (format == nullptr || stream == nullptr || stream->failedToOpen()) {
+            result.error = "cannot create " + outputFile.getFullPathName();
+            return result;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), reader->sampleRate, (unsigned int) fileChannels,
+                                                                               (int) reader->bitsPerSample, reader->metadataValues, 0));
+        if (writer == nullptr) {
+            result.error = "cannot create a writer for " + outputFile.getFullPathName();
+            return result;
+        }
+        stream.release(); // appartient maintenant au writer
+
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+
+        processor.setNonRealtime(true);
+        processor.setRateAndBufferSizeDetails(reader->sampleRate, o.blockSize);
+        processor.prepareToPlay(reader->sampleRate, o.blockSize);
+        const int latency = processor.getLatencySamples();
+
+        juce::AudioBuffer<float> buffer(numChannels, o.blockSize);
+        juce::MidiBuffer midi;
+        const juce::int64 totalSamples = reader->lengthInSamples;
+
+        // On traite latency échantillons de plus et on saute le début de la sortie
+        juce::int64 toSkip = latency;
+        for (juce::int64 pos = 0; pos < totalSamples + latency; pos += o.blockSize) {
+            const int numSamples = (int) juce::jmin((juce::int64) o.blockSize, totalSamples + latency - pos);
+            buffer.setSize(numChannels, numSamples, false, false, true);
+            buffer.clear();
+
+            const int toRead = (int) juce::jlimit((juce::int64) 0, (juce::int64) numSamples, totalSamples - pos);
+            if (toRead > 0) {
+                reader->read(&buffer, 0, toRead, pos, true, true);
+                if (fileChannels == 1)
+                    buffer.copyFrom(1, 0, buffer, 0, 0, toRead);
+            }
+
+            processor.processBlock(buffer, midi);
+
+            const int skip = (int) juce::jmin(toSkip, (juce::int64) numSamples);
+            toSkip -= skip;
+            if (numSamples - skip > 0)
+                writer->writeFromAudioSampleBuffer(buffer, skip, numSamples - skip);
+        }
+
+        processor.releaseResources();
+        writer.reset();
+
+        result.renderSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+        result.audioSeconds = (double) totalSamples / reader->sampleRate;
+        result.ok = true;
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    Options options;
+    if (!parseArgs(args, options)) {
+        std::cerr << "Usage: MerjEQBatch [--preset file] [--set ParamID=value]... [--out dir] [--threads n] [--block n] files..." << std::endl;
+        return 1;
+    }
+
+    juce::MemoryBlock presetData;
+    if (options.preset != juce::File() && !options.preset.loadFileAsData(presetData)) {
+        std::cerr << "Cannot read preset " << options.preset.getFullPathName() << std::endl;
+        return 1;
+    }
+    if (options.outputDir != juce::File())
+        options.outputDir.createDirectory();
+
+    const int numWorkers = juce::jmin(options.numThreads, options.inputs.size());
+    ProcessorPool pool;
+    for (int i = 0; i < numWorkers; ++i) {
+        std::unique_ptr<MerjEQAudioProcessor> p(static_cast<MerjEQAudioProcessor*>(createPluginFilter()));
+        if (!configure(*p, options, presetData))
+            return 1;
+        pool.add(std::move(p));
+    }
+
+    juce::CriticalSection resultLock;
+    std::vector<FileResult> results;
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    {
+        juce::ThreadPool threads(numWorkers);
+        for (auto& file : options.inputs) {
+            threads.addJob([&, file] {
+                juce::AudioFormatManager formats;
+                formats.registerBasicFormats();
+
+                auto* processor = pool.acquire();
+                auto r = renderFile(*processor, formats, file, options);
+                pool.release(processor);
+
+                const juce::ScopedLock sl(resultLock);
+                if (r.ok)
+                    std::cout << file.getFileName() << ": " << juce::String(r.audioSeconds, 1) << " s of audio in "
+                              << juce::String(r.renderSeconds, 2) << " s, realtime x" << juce::String(r.audioSeconds / r.renderSeconds, 1) << std::endl;
+                else
+                    std::cerr << file.getFileName() << ": " << r.error << std::endl;
+                results.push_back(r);
+            });
+        }
+        // Le destructeur du pool retire les jobs pas encore lancés : on attend qu'ils soient tous finis
+        while (threads.getNumJobs() > 0)
+            juce::Thread::sleep(10);
+    }
+    const double wallSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+    double audioSeconds = 0.0, renderSeconds = 0.0;
+    int failures = 0;
+    for (auto& r : results) {
+        audioSeconds += r.audioSeconds;
+        renderSeconds += r.renderSeconds;
+        failures += r.ok ? 0 : 1;
+    }
+
+    std::cout << "Total: " << (int) results.size() - failures << " files, " << juce::String(audioSeconds, 1) << " s of audio in "
+              << juce::String(wallSeconds, 2) << " s with " << numWorkers << " workers, aggregate realtime x"
+              << juce::String(audioSeconds / juce::jmax(1.0e-9, wallSeconds), 1)
+              << " (x" << juce::String(audioSeconds / juce::jmax(1.0e-9, renderSeconds), 1) << " per worker)" << std::endl;
+
+    return failures == 0 ? 0 : 2;
+}
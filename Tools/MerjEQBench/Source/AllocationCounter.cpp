@@ -0,0 +1,103 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+#if JUCE_WINDOWS
+ #include <malloc.h>
+#endif
+
+// glibc exporte ses allocateurs sous un second nom : malloc & co. peuvent être remplacés
+// dans l'exécutable et leur déléguer, sans dlsym (qui alloue lui-même)
+#if defined(__GLIBC__)
+ #define MERJEQ_COUNT_MALLOC 1
+extern "C"
+{
+    void* __libc_malloc(std::size_t);
+    void* __libc_calloc(std::size_t, std::size_t);
+    void* __libc_realloc(void*, std::size_t);
+    void* __libc_memalign(std::size_t, std::size_t);
+    void __libc_free(void*);
+}
+#else
+ #define MERJEQ_COUNT_MALLOC 0
+#endif
+
+namespace
+{
+    // Types triviaux : TLS statique, aucune allocation au premier accès depuis malloc
+    thread_local bool counting = false;
+    thread_local juce::int64 count = 0;
+
+    inline void note() noexcept
+    {
+        if (counting)
+            ++count;
+    }
+
+   #if MERJEQ_COUNT_MALLOC
+    inline void* rawMalloc(std::size_t size) noexcept { return __libc_malloc(size); }
+    inline void rawFree(void* p) noexcept { __libc_free(p); }
+    inline void* rawAligned(std::size_t size, std::size_t alignment) noexcept { return __libc_memalign(alignment, size); }
+    inline void rawAlignedFree(void* p) noexcept { __libc_free(p); }
+   #elif JUCE_WINDOWS
+    inline void* rawMalloc(std::size_t size) noexcept { return std::malloc(size); }
+    inline void rawFree(void* p) noexcept { std::free(p); }
+    inline void* rawAligned(std::size_t size, std::size_t alignment) noexcept { return _aligned_malloc(size, alignment); }
+    inline void rawAlignedFree(void* p) noexcept { _aligned_free(p); }
+   #else
+    inline void* rawMalloc(std::size_t size) noexcept { return std::malloc(size); }
+    inline void rawFree(void* p) noexcept { std::free(p); }
+    inline void* rawAligned(std::size_t size, std::size_t alignment) noexcept
+    {
+        void* p = nullptr;
+        return posix_memalign(&p, juce::jmax(alignment, sizeof(void*)), size) == 0 ? p : nullptr;
+    }
+    inline void rawAlignedFree(void* p) noexcept { std::free(p); }
+   #endif
+
+    void* allocate(std::size_t size)
+    {
+        note();
+        if (auto* p = rawMalloc(size > 0 ? size : 1))
+            return p;
+        throw std::bad_alloc();
+    }
+
+    void* allocateAligned(std::size_t size, std::align_val_t alignment)
+    {
+        note();
+        if (auto* p = rawAligned(size > 0 ? size : 1, (std::size_t) alignment))
+            return p;
+        throw std::bad_alloc();
+    }
+}
+
+namespace AllocationCounter
+{
+    void start() noexcept { count = 0; counting = true; }
+    juce::int64 stop() noexcept { counting = false; return count; }
+    bool countsMalloc() noexcept { return MERJEQ_COUNT_MALLOC != 0; }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+void* operator new[](std::size_t size) { return allocate(size); }
+void operator delete(void* p) noexcept { rawFree(p); }
+void operator delete[](void* p) noexcept { rawFree(p); }
+void operator delete(void* p, std::size_t) noexcept { rawFree(p); }
+void operator delete[](void* p, std::size_t) noexcept { rawFree(p); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void* p, std::align_val_t) noexcept { rawAlignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { rawAlignedFree(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { rawAlignedFree(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { rawAlignedFree(p); }
+
+#if MERJEQ_COUNT_MALLOC
+extern "C"
+{
+    void* malloc(std::size_t size) { note(); return __libc_malloc(size); }
+    void* calloc(std::size_t n, std::size_t size) { note(); return __libc_calloc(n, size); }
+    void* realloc(void* p, std::size_t size) { note(); return __libc_realloc(p, size); }
+    void free(void* p) { __libc_free(p); }
+}
+#endif
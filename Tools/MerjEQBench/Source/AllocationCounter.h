@@ -0,0 +1,14 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Compte les allocations faites par le thread courant entre start() et stop() :
+// operator new (alignés compris) partout, et malloc/calloc/realloc là où on peut les
+// intercepter (glibc). Ailleurs, HeapBlock (AudioBuffer, Array, MemoryBlock) y échappe.
+namespace AllocationCounter
+{
+    void start() noexcept;
+    juce::int64 stop() noexcept;
+
+    // false : seuls les operator new sont comptés
+    bool countsMalloc() noexcept;
+}
@@ -0,0 +1,225 @@
+/*
+  ==============================================================================
+
+    Comparaison isolée des moteurs de filtrage et des noyaux de saturation
+    (sans passer par le processeur).
+
+    Usage : MerjEQBench --engines [--rate 48000] [--block 512] [--seconds 10]
+
+    Code de retour 5 si le moteur dynamique coûte plus de 2x le moteur statique
+    par défaut (cascade fusionnée), en statique ou sous automation.
+
+  ==============================================================================
+*/
+
+#include "EngineBench.h"
+#include <chrono>
+#include <iostream>
+#include "../../../Source/BiquadCascade.h"
+#include "../../../Source/EQCoefficients.h"
+#include "../../../Source/StateVariableEQ.h"
+#include "../../../Source/DynamicEQ.h"
+#include "../../../Source/Waveshaper.h"
+
+namespace
+{
+    constexpr int numChannels = 2;
+    constexpr double maxDynamicRatio = 2.0;
+
+    struct Settings
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        double seconds = 10.0;
+    };
+
+    Settings parseArgs(const juce::StringArray& args)
+    {
+        Settings s;
+        auto valueAfter = [&args](const char* flag) { return args[args.indexOf(flag) + 1]; };
+        if (args.contains("--rate"))    s.sampleRate = valueAfter("--rate").getDoubleValue();
+        if (args.contains("--block"))   s.blockSize = valueAfter("--block").getIntValue();
+        if (args.contains("--seconds")) s.seconds = valueAfter("--seconds").getDoubleValue();
+        s.blockSize = juce::jmax(1, s.blockSize);
+        return s;
+    }
+
+    // Paramètres d'une automation rapide : une sinusoïde lente sur les gains et le Q
+    EQParameters automatedParameters(int block)
+    {
+        const float phase = (float) block * 0.05f;
+        return { 12.0f * std::sin(phase), 12.0f * std::sin(phase * 1.3f), 12.0f * std::sin(phase * 0.7f),
+                 2.5f + 2.4f * std::sin(phase * 0.9f) };
+    }
+
+    // Chaîne d'origine : 3 juce::dsp::IIR::Filter par canal, 3 passes
+    struct LegacyChain
+    {
+        juce::dsp::IIR::Filter<float> low[numChannels], mid[numChannels], high[numChannels];
+        double sampleRate = 44100.0;
+
+        void prepare(double rate, int blockSize)
+        {
+            sampleRate = rate;
+            juce::dsp::ProcessSpec spec { rate, (juce::uint32) blockSize, 1 };
+            for (int ch = 0; ch < numChannels; ++ch) {
+                low[ch].prepare(spec);
+                mid[ch].prepare(spec);
+                high[ch].prepare(spec);
+            }
+            setParameters({});
+        }
+
+        // Recalcul par bloc, comme updateFilters() d'origine
+        void setParameters(const EQParameters& p)
+        {
+            auto l = juce::dsp::IIR::Coefficients<float>::makeLowShelf(sampleRate, EQBands::lowFrequency, EQBands::shelfQ, juce::Decibels::decibelsToGain(p.lowGain));
+            auto m = juce::dsp::IIR::Coefficients<float>::makePeakFilter(sampleRate, EQBands::midFrequency, p.midQ, juce::Decibels::decibelsToGain(p.midGain));
+            auto h = juce::dsp::IIR::Coefficients<float>::makeHighShelf(sampleRate, EQBands::highFrequency, EQBands::shelfQ, juce::Decibels::decibelsToGain(p.highGain));
+            for (int ch = 0; ch < numChannels; ++ch) {
+                low[ch].coefficients = l;
+                mid[ch].coefficients = m;
+                high[ch].coefficients = h;
+            }
+        }
+
+        void process(juce::AudioBuffer<float>& buffer)
+        {
+            juce::dsp::AudioBlock<float> block(buffer);
+            for (int ch = 0; ch < numChannels; ++ch) {
+                auto channelBlock = block.getSingleChannelBlock((size_t) ch);
+                juce::dsp::ProcessContextReplacing<float> context(channelBlock);
+                low[ch].process(context);
+                mid[ch].process(context);
+                high[ch].process(context);
+            }
+        }
+    };
+
+    struct Engine
+    {
+        juce::String name;
+        std::function<void(double, int)> prepare;
+        std::function<void(const EQParameters&)> setParameters;
+        std::function<void(juce::AudioBuffer<float>&)> process;
+    };
+
+    // ns par échantillon et par canal, mesuré sur du bruit blanc
+    double measure(Engine& engine, const Settings& s, bool automated)
+    {
+        juce::AudioBuffer<float> source(numChannels, s.blockSize), buffer(numChannels, s.blockSize);
+        juce::Random random(1234);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < s.blockSize; ++i)
+                source.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+        engine.prepare(s.sampleRate, s.blockSize);
+        engine.setParameters({ 6.0f, -4.0f, 3.0f, 2.0f });
+
+        const int numBlocks = juce::jmax(1, (int) (s.seconds * s.sampleRate / s.blockSize));
+        juce::ScopedNoDenormals noDenormals;
+
+        const auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < numBlocks; ++b) {
+            buffer.makeCopyOf(source, true);
+            if (automated)
+                engine.setParameters(automatedParameters(b));
+            engine.process(buffer);
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        return elapsed / ((double) numBlocks * s.blockSize * numChannels);
+    }
+
+    // ns par échantillon d'un noyau de saturation, signal à ±1.5 pour couvrir la zone non linéaire
+    double measureSaturation(Waveshaper::Quality quality, const Settings& s)
+    {
+        juce::AudioBuffer<float> source(numChannels, s.blockSize), buffer(numChannels, s.blockSize);
+        juce::Random random(1234);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < s.blockSize; ++i)
+                source.setSample(ch, i, random.nextFloat() * 3.0f - 1.5f);
+
+        const int numBlocks = juce::jmax(1, (int) (s.seconds * s.sampleRate / s.blockSize));
+        const auto start = std::chrono::steady_clock::now();
+        for (int b = 0; b < numBlocks; ++b) {
+            buffer.makeCopyOf(source, true);
+            for (int ch = 0; ch < numChannels; ++ch)
+                Waveshaper::processSoft(buffer.getWritePointer(ch), s.blockSize, Waveshaper::softDrive, quality);
+        }
+        const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        return elapsed / ((double) numBlocks * s.blockSize * numChannels);
+    }
+}
+
+int runEngineBench(const juce::StringArray& args)
+{
+    const auto settings = parseArgs(args);
+
+    LegacyChain legacy;
+    BiquadCascade<float> cascade;
+    StateVariableEQ<float> svf;
+    DynamicEQ<float> dynamic;
+    DynamicEQSettings dynamicSettings;
+    dynamicSettings.enabled = { false, true, true };
+    dynamicSettings.thresholdDb = { -30.0f, -24.0f, -24.0f };
+    double cascadeRate = 44100.0;
+
+    std::vector<Engine> engines {
+        { "juce IIR (3 passes)",
+          [&](double r, int bs) { legacy.prepare(r, bs); },
+          [&](const EQParameters& p) { legacy.setParameters(p); },
+          [&](juce::AudioBuffer<float>& b) { legacy.process(b); } },
+        { "fused SIMD cascade",
+          [&](double r, int) { cascadeRate = r; cascade.prepare(numChannels); },
+          [&](const EQParameters& p) {
+              for (int band = 0; band < EQBands::numBands; ++band)
+                  cascade.setCoefficients(band, EQDesign::makeBand(band, cascadeRate, p));
+          },
+          [&](juce::AudioBuffer<float>& b) { cascade.process(b.getArrayOfWritePointers(), numChannels, b.getNumSamples()); } },
+        { "state variable (smoothed)",
+          [&](double r, int) { svf.prepare(r, numChannels); },
+          [&](const EQParameters& p) { svf.setParameters(p); },
+          [&](juce::AudioBuffer<float>& b) { svf.process(b.getArrayOfWritePointers(), numChannels, b.getNumSamples()); } },
+        { "dynamic (mid + high)",
+          [&](double r, int) { dynamic.prepare(r, numChannels); },
+          [&](const EQParameters& p) { dynamic.setParameters(p, dynamicSettings); },
+          [&](juce::AudioBuffer<float>& b) { dynamic.process(b.getArrayOfWritePointers(), numChannels, b.getNumSamples()); } },
+    };
+    // Référence du moteur dynamique : la cascade fusionnée, moteur statique par défaut du plugin
+    const size_t referenceEngine = 1, dynamicEngine = 3;
+    std::vector<std::pair<double, double>> costs;
+
+    std::cout << "MerjEQBench  rate " << settings.sampleRate << " Hz, block " << settings.blockSize
+              << ", " << settings.seconds << " s of audio per case" << std::endl;
+    std::cout << "engine                          static ns/sample   automated ns/sample" << std::endl;
+
+    for (auto& engine : engines) {
+        const double staticCost = measure(engine, settings, false);
+        const double automatedCost = measure(engine, settings, true);
+        std::cout << engine.name.paddedRight(' ', 32)
+                  << juce::String(staticCost, 2).paddedLeft(' ', 16)
+                  << juce::String(automatedCost, 2).paddedLeft(' ', 22) << std::endl;
+        costs.push_back({ staticCost, automatedCost });
+    }
+
+    const double staticRatio = costs[dynamicEngine].first / costs[referenceEngine].first;
+    const double automatedRatio = costs[dynamicEngine].second / costs[referenceEngine].second;
+    const bool withinBudget = staticRatio <= maxDynamicRatio && automatedRatio <= maxDynamicRatio;
+    std::cout << std::endl << "dynamic / " << engines[referenceEngine].name << ": "
+              << juce::String(staticRatio, 2) << "x static, " << juce::String(automatedRatio, 2) << "x automated"
+              << (withinBudget ? juce::String() : "  (over " + juce::String(maxDynamicRatio, 1) + "x)") << std::endl;
+
+    std::cout << std::endl << "saturation (tanh, +6 dB)        ns/sample" << std::endl;
+    const std::pair<Waveshaper::Quality, const char*> qualities[] = {
+        { Waveshaper::Quality::exact, "exact (libm)" },
+        { Waveshaper::Quality::high, "high (rational 7/6)" },
+        { Waveshaper::Quality::fast, "fast (rational 3/2)" },
+    };
+    for (auto& [quality, name] : qualities)
+        std::cout << juce::String(name).paddedRight(' ', 32)
+                  << juce::String(measureSaturation(quality, settings), 2).paddedLeft(' ', 9) << std::endl;
+
+    return withinBudget ? 0 : 5;
+}
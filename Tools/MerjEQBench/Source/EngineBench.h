@@ -0,0 +1,5 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Coût des moteurs de filtrage et des noyaux de saturation pris isolément
+int runEngineBench(const juce::StringArray& args);
@@ -0,0 +1,34 @@
+/*
+  ==============================================================================
+
+    MerjEQBench : benchmarks headless de MerjEQ.
+
+      MerjEQBench [--json fichier] [--seconds s] [--quick] [--engine legacy|fused|svf|linear|dynamic]
+          matrice complète de processBlock (voir ProcessBlockBench.cpp)
+      MerjEQBench --engines [--rate r] [--block n] [--seconds s]
+          moteurs de filtrage et noyaux de saturation pris isolément
+      MerjEQBench --verify [--seconds s] [--json fichier]
+          chemins optimisés comparés aux références (erreur, null, amplitude, temps)
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "EngineBench.h"
+#include "ProcessBlockBench.h"
+#include "VerifyBench.h"
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInit;
+
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(argv[i]);
+
+    if (args.contains("--engines"))
+        return runEngineBench(args);
+    if (args.contains("--verify"))
+        return runVerifyBench(args);
+    return runProcessBlockBench(args);
+}
@@ -0,0 +1,301 @@
+/*
+  ==============================================================================
+
+    Usage : MerjEQBench [--json resultats.json] [--seconds 0.5] [--quick]
+                        [--engine legacy|fused|svf|linear|dynamic] [--double]
+
+    Pour chaque cellule : ns/échantillon (par canal), cycles/échantillon et
+    nombre d'allocations faites pendant processBlock.
+
+  ==============================================================================
+*/
+
+#include "ProcessBlockBench.h"
+#include "AllocationCounter.h"
+#include "../../../Source/PluginProcessor.h"
+#include <chrono>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #if defined(_MSC_VER)
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+ #define MERJEQ_BENCH_HAS_RDTSC 1
+#else
+ #define MERJEQ_BENCH_HAS_RDTSC 0
+#endif
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter();
+
+namespace
+{
+    struct Cell
+    {
+        int blockSize;
+        double sampleRate;
+        juce::AudioChannelSet layout;
+        int numChannels;
+        bool saturation;
+        bool automated;
+    };
+
+    struct Result
+    {
+        Cell cell;
+        double nsPerSample = 0.0;
+        double cyclesPerSample = -1.0;  // -1 : pas de compteur disponible
+        juce::int64 allocations = 0;
+        juce::int64 numBlocks = 0;
+    };
+
+    struct Options
+    {
+        juce::File jsonFile;
+        double seconds = 0.5;
+        bool quick = false;
+        MerjEQAudioProcessor::FilterEngine engine = MerjEQAudioProcessor::FilterEngine::fusedCascade;
+        bool doublePrecision = false;   // processBlock(AudioBuffer<double>&), comme un hôte 64 bits
+    };
+
+    Options parseArgs(const juce::StringArray& args)
+    {
+        Options o;
+        auto valueAfter = [&args](const char* flag) { return args[args.indexOf(flag) + 1]; };
+        if (args.contains("--json"))    o.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(valueAfter("--json"));
+        if (args.contains("--seconds")) o.seconds = juce::jmax(0.01, valueAfter("--seconds").getDoubleValue());
+        o.quick = args.contains("--quick");
+        o.doublePrecision = args.contains("--double");
+
+        const auto engine = valueAfter("--engine");
+        if (engine == "legacy")   o.engine = MerjEQAudioProcessor::FilterEngine::legacyIIR;
+        else if (engine == "svf") o.engine = MerjEQAudioProcessor::FilterEngine::stateVariable;
+        else if (engine == "linear") o.engine = MerjEQAudioProcessor::FilterEngine::linearPhase;
+        else if (engine == "dynamic") o.engine = MerjEQAudioProcessor::FilterEngine::dynamic;
+        return o;
+    }
+
+    juce::String engineName(MerjEQAudioProcessor::FilterEngine e)
+    {
+        switch (e) {
+            case MerjEQAudioProcessor::FilterEngine::legacyIIR:     return "legacy";
+            case MerjEQAudioProcessor::FilterEngine::stateVariable: return "svf";
+            case MerjEQAudioProcessor::FilterEngine::linearPhase:   return "linear";
+            case MerjEQAudioProcessor::FilterEngine::dynamic:       return "dynamic";
+            case MerjEQAudioProcessor::FilterEngine::fusedCascade:
+            default: break;
+        }
+        return "fused";
+    }
+
+    std::vector<Cell> buildMatrix(bool quick)
+    {
+        const std::vector<int> blockSizes = quick ? std::vector<int>{ 64, 512 } : std::vector<int>{ 1, 16, 64, 256, 512, 1024, 4096 };
+        const std::vector<double> rates = quick ? std::vector<double>{ 48000.0 } : std::vector<double>{ 44100.0, 48000.0, 96000.0, 192000.0 };
+        // Du mono à l'Atmos (7.1.4) et à l'ambisonie d'ordre 3 (16 canaux)
+        const std::vector<juce::AudioChannelSet> layouts = quick
+            ? std::vector<juce::AudioChannelSet>{ juce::AudioChannelSet::stereo(), juce::AudioChannelSet::create7point1point4() }
+            : std::vector<juce::AudioChannelSet>{ juce::AudioChannelSet::mono(), juce::AudioChannelSet::stereo(),
+                                                  juce::AudioChannelSet::create5point1(), juce::AudioChannelSet::create7point1point4(),
+                                                  juce::AudioChannelSet::ambisonic(3) };
+
+        std::vector<Cell> cells;
+        for (auto rate : rates)
+            for (auto bs : blockSizes)
+                for (auto& layout : layouts)
+                    for (bool sat : { false, true })
+                        for (bool automated : { false, true })
+                            cells.push_back({ bs, rate, layout, layout.size(), sat, automated });
+        return cells;
+    }
+
+    juce::uint64 readCycles() noexcept
+    {
+       #if MERJEQ_BENCH_HAS_RDTSC
+        return (juce::uint64) __rdtsc();
+       #else
+        return 0;
+       #endif
+    }
+
+    void setParameter(MerjEQAudioProcessor& p, const char* id, float value)
+    {
+        if (auto* param = p.apvts.getParameter(id))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+    }
+
+    // Automation continue, comme un hôte qui écrit les paramètres avant chaque bloc
+    void automate(MerjEQAudioProcessor& p, juce::int64 block)
+    {
+        const float phase = (float) block * 0.05f;
+        setParameter(p, "LowGain", 12.0f * std::sin(phase));
+        setParameter(p, "MidGain", 12.0f * std::sin(phase * 1.3f));
+        setParameter(p, "HighGain", 12.0f * std::sin(phase * 0.7f));
+        setParameter(p, "MidQ", 2.5f + 2.4f * std::sin(phase * 0.9f));
+    }
+
+    // Bruit à -12 dBFS, recopié avant chaque bloc (hors chronométrage)
+    template <typename SampleType>
+    void measureBlocks(MerjEQAudioProcessor& processor, const Cell& cell, juce::int64 numBlocks, Result& result)
+    {
+        juce::AudioBuffer<SampleType> source(cell.numChannels, cell.blockSize), buffer(cell.numChannels, cell.blockSize);
+        juce::Random random(42);
+        for (int ch = 0; ch < cell.numChannels; ++ch)
+            for (int i = 0; i < cell.blockSize; ++i)
+                source.setSample(ch, i, (SampleType) (random.nextFloat() * 0.5f - 0.25f));
+        juce::MidiBuffer midi;
+
+        const auto warmUp = numBlocks / 10 + 1;
+
+        double nanos = 0.0;
+        juce::uint64 cycles = 0;
+        juce::int64 allocations = 0;
+
+        for (juce::int64 b = 0; b < warmUp + numBlocks; ++b) {
+            buffer.copyFrom(0, 0, source, 0, 0, cell.blockSize);
+            for (int ch = 1; ch < cell.numChannels; ++ch)
+                buffer.copyFrom(ch, 0, source, ch, 0, cell.blockSize);
+            if (cell.automated)
+                automate(processor, b);
+
+            const bool measured = b >= warmUp;
+            if (measured)
+                AllocationCounter::start();
+            const auto c0 = readCycles();
+            const auto t0 = std::chrono::steady_clock::now();
+
+            processor.processBlock(buffer, midi);
+
+            const auto t1 = std::chrono::steady_clock::now();
+            const auto c1 = readCycles();
+            if (measured) {
+                allocations += AllocationCounter::stop();
+                nanos += std::chrono::duration<double, std::nano>(t1 - t0).count();
+                cycles += c1 - c0;
+            }
+        }
+
+        const double samples = (double) numBlocks * cell.blockSize * cell.numChannels;
+        result.nsPerSample = nanos / samples;
+        result.allocations = allocations;
+        if (MERJEQ_BENCH_HAS_RDTSC)
+            result.cyclesPerSample = (double) cycles / samples;
+    }
+
+    bool runCell(const Cell& cell, const Options& o, Result& result)
+    {
+        std::unique_ptr<MerjEQAudioProcessor> processor(static_cast<MerjEQAudioProcessor*>(createPluginFilter()));
+
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(cell.layout);
+        layout.outputBuses.add(cell.layout);
+        if (!processor->setBusesLayout(layout))
+            return false;
+
+        processor->filterEngine = o.engine;
+        processor->setNonRealtime(false);
+        setParameter(*processor, "saturationEnabled", cell.saturation ? 1.0f : 0.0f);
+        setParameter(*processor, "LowGain", 4.0f);
+        setParameter(*processor, "MidGain", -3.0f);
+        setParameter(*processor, "HighGain", 2.0f);
+        // Mode dynamique : mid et high suivent leur niveau (le paramètre choisit le moteur)
+        if (o.engine == MerjEQAudioProcessor::FilterEngine::dynamic) {
+            setParameter(*processor, "MidDynamic", 1.0f);
+            setParameter(*processor, "HighDynamic", 1.0f);
+        }
+        processor->setRateAndBufferSizeDetails(cell.sampleRate, cell.blockSize);
+        processor->setProcessingPrecision(o.doublePrecision ? juce::AudioProcessor::doublePrecision
+                                                            : juce::AudioProcessor::singlePrecision);
+        processor->prepareToPlay(cell.sampleRate, cell.blockSize);
+
+        const auto numBlocks = juce::jmax((juce::int64) 16, (juce::int64) (o.seconds * cell.sampleRate / cell.blockSize));
+        if (o.doublePrecision)
+            measureBlocks<double>(*processor, cell, numBlocks, result);
+        else
+            measureBlocks<float>(*processor, cell, numBlocks, result);
+        processor->releaseResources();
+
+        result.cell = cell;
+        result.numBlocks = numBlocks;
+
+        if (auto mhz = juce::SystemStats::getCpuSpeedInMegahertz(); !MERJEQ_BENCH_HAS_RDTSC && mhz > 0)
+            result.cyclesPerSample = result.nsPerSample * mhz * 0.001;   // estimation à fréquence nominale
+        return true;
+    }
+
+    juce::var toJson(const std::vector<Result>& results, const Options& o)
+    {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("plugin", JucePlugin_Name);
+        root->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("os", juce::SystemStats::getOperatingSystemName());
+        root->setProperty("engine", engineName(o.engine));
+        root->setProperty("precision", o.doublePrecision ? "double" : "float");
+        root->setProperty("cyclesSource", MERJEQ_BENCH_HAS_RDTSC ? "rdtsc" : "estimated");
+
+        juce::Array<juce::var> cells;
+        for (auto& r : results) {
+            auto* obj = new juce::DynamicObject();
+            obj->setProperty("blockSize", r.cell.blockSize);
+            obj->setProperty("sampleRate", r.cell.sampleRate);
+            obj->setProperty("layout", r.cell.layout.getDescription());
+            obj->setProperty("channels", r.cell.numChannels);
+            obj->setProperty("saturation", r.cell.saturation);
+            obj->setProperty("automated", r.cell.automated);
+            obj->setProperty("nsPerSample", r.nsPerSample);
+            obj->setProperty("cyclesPerSample", r.cyclesPerSample >= 0.0 ? juce::var(r.cyclesPerSample) : juce::var());
+            obj->setProperty("allocations", r.allocations);
+            obj->setProperty("blocks", r.numBlocks);
+            cells.add(juce::var(obj));
+        }
+        root->setProperty("results", cells);
+        return juce::var(root);
+    }
+}
+
+int runProcessBlockBench(const juce::StringArray& args)
+{
+    const auto options = parseArgs(args);
+    const auto cells = buildMatrix(options.quick);
+
+    std::cout << "MerjEQBench processBlock matrix, engine " << engineName(options.engine)
+              << (options.doublePrecision ? " (double)" : "") << ", "
+              << options.seconds << " s of audio per cell" << std::endl;
+    if (!AllocationCounter::countsMalloc())
+        std::cout << "  (allocs: operator new only on this platform, malloc/realloc not intercepted)" << std::endl;
+    std::cout << "  rate  block  ch  sat  auto    ns/sample  cycles/sample  allocs" << std::endl;
+
+    std::vector<Result> results;
+    juce::int64 totalAllocations = 0;
+    for (auto& cell : cells) {
+        Result r;
+        if (!runCell(cell, options, r)) {
+            std::cout << "  skipped unsupported layout: " << cell.layout.getDescription() << std::endl;
+            continue;
+        }
+        totalAllocations += r.allocations;
+        results.push_back(r);
+
+        std::cout << juce::String(cell.sampleRate / 1000.0, 1).paddedLeft(' ', 6)
+                  << juce::String(cell.blockSize).paddedLeft(' ', 7)
+                  << juce::String(cell.numChannels).paddedLeft(' ', 4)
+                  << juce::String(cell.saturation ? "on" : "off").paddedLeft(' ', 5)
+                  << juce::String(cell.automated ? "yes" : "no").paddedLeft(' ', 6)
+                  << juce::String(r.nsPerSample, 2).paddedLeft(' ', 13)
+                  << (r.cyclesPerSample >= 0.0 ? juce::String(r.cyclesPerSample, 1) : juce::String("n/a")).paddedLeft(' ', 15)
+                  << juce::String(r.allocations).paddedLeft(' ', 8) << std::endl;
+    }
+
+    if (options.jsonFile != juce::File()) {
+        if (!options.jsonFile.replaceWithText(juce::JSON::toString(toJson(results, options)))) {
+            std::cerr << "Cannot write " << options.jsonFile.getFullPathName() << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << options.jsonFile.getFullPathName() << std::endl;
+    }
+
+    // Code de retour non nul si processBlock a alloué : utilisable tel quel en CI
+    return totalAllocations == 0 ? 0 : 3;
+}
@@ -0,0 +1,7 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Matrice de benchmarks de MerjEQAudioProcessor::processBlock :
+// taille de bloc x fréquence x canaux x saturation x automation.
+// Sortie texte et, avec --json, un fichier JSON comparable d'une version à l'autre.
+int runProcessBlockBench(const juce::StringArray& args);
@@ -0,0 +1,400 @@
+/*
+  ==============================================================================
+
+    Vérification numérique : chemins optimisés contre les références.
+
+    Usage : MerjEQBench --verify [--seconds 1] [--json verification.json]
+
+    Référence EQ : la chaîne juce::dsp::IIR::Filter d'origine (3 passes), calculée
+    en double pour que ses propres arrondis ne masquent pas ceux des chemins testés ;
+    la même chaîne en float figure parmi les chemins. Référence saturation :
+    Waveshaper::softSaturation (tanh libm), et la même formule en double pour les
+    noyaux double.
+
+    Pour chaque fréquence d'échantillonnage et chaque signal (sweep log, bruit blanc,
+    impulsion) : erreur max, profondeur de null (énergie de l'erreur / énergie de la
+    référence) et ns/échantillon des deux côtés. Amplitude mesurée à 200 Hz, 4 kHz et
+    12 kHz sur la réponse impulsionnelle. Code de retour 4 si un chemin dépasse sa
+    tolérance de null : utilisable tel quel en CI.
+
+    La phase linéaire n'est pas comparée : sa latence et sa phase diffèrent
+    par construction, un null n'aurait pas de sens.
+
+  ==============================================================================
+*/
+
+#include "VerifyBench.h"
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <iostream>
+#include "../../../Source/BiquadCascade.h"
+#include "../../../Source/CoefficientTable.h"
+#include "../../../Source/EQCoefficients.h"
+#include "../../../Source/StateVariableEQ.h"
+#include "../../../Source/Waveshaper.h"
+
+namespace
+{
+    constexpr double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+    constexpr float probeFrequencies[] = { EQBands::lowFrequency, EQBands::midFrequency, EQBands::highFrequency };
+    const EQParameters testParameters { 6.0f, -4.0f, 3.0f, 2.0f };
+    constexpr double eqAmplitude = 0.5, saturationAmplitude = 1.5;
+    constexpr double nullFloorDb = -300.0;     // erreur nulle
+
+    struct Options
+    {
+        double seconds = 1.0;
+        juce::File jsonFile;
+    };
+
+    Options parseArgs(const juce::StringArray& args)
+    {
+        Options o;
+        auto valueAfter = [&args](const char* flag) { return args[args.indexOf(flag) + 1]; };
+        if (args.contains("--seconds")) o.seconds = juce::jmax(0.05, valueAfter("--seconds").getDoubleValue());
+        if (args.contains("--json"))    o.jsonFile = juce::File::getCurrentWorkingDirectory().getChildFile(valueAfter("--json"));
+        return o;
+    }
+
+    struct Signal
+    {
+        juce::String name;
+        std::vector<double> samples;
+    };
+
+    // Sweep log de 20 Hz à 0.45 fs, bruit blanc, impulsion
+    std::vector<Signal> makeSignals(double sampleRate, int numSamples, double amplitude, bool withImpulse)
+    {
+        std::vector<Signal> signals { { "sweep", {} }, { "noise", {} } };
+        if (withImpulse)
+            signals.push_back({ "impulse", {} });
+        for (auto& s : signals)
+            s.samples.assign((size_t) numSamples, 0.0);
+
+        const double f0 = 20.0, f1 = 0.45 * sampleRate, duration = numSamples / sampleRate;
+        const double k = std::log(f1 / f0);
+        juce::Random random(1234);
+        for (int i = 0; i < numSamples; ++i) {
+            const double t = i / sampleRate;
+            const double phase = juce::MathConstants<double>::twoPi * f0 * duration / k * (std::exp(t / duration * k) - 1.0);
+            signals[0].samples[(size_t) i] = amplitude * std::sin(phase);
+            signals[1].samples[(size_t) i] = amplitude * (2.0 * random.nextDouble() - 1.0);
+        }
+        if (withImpulse)
+            signals[2].samples[0] = amplitude;
+        return signals;
+    }
+
+    template <typename Fn>
+    double timeNs(Fn&& fn)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Traitement sur place dans la précision du chemin ; seules les conversions sont hors chrono
+    template <typename SampleType, typename Fn>
+    double runIn(std::vector<double>& data, Fn&& fn)
+    {
+        std::vector<SampleType> buffer(data.size());
+        std::transform(data.begin(), data.end(), buffer.begin(), [](double x) { return (SampleType) x; });
+        SampleType* channels[] = { buffer.data() };
+        const double ns = timeNs([&] { fn(channels, (int) buffer.size()); });
+        std::transform(buffer.begin(), buffer.end(), data.begin(), [](SampleType x) { return (double) x; });
+        return ns;
+    }
+
+    // Chaîne d'origine : 3 juce::dsp::IIR::Filter, coefficients JUCE, 3 passes
+    template <typename SampleType>
+    struct JuceChain
+    {
+        using Coefficients = juce::dsp::IIR::Coefficients<SampleType>;
+
+        JuceChain(double rate, const EQParameters& p)
+            : low(Coefficients::makeLowShelf(rate, EQBands::lowFrequency, EQBands::shelfQ, juce::Decibels::decibelsToGain((SampleType) p.lowGain))),
+              mid(Coefficients::makePeakFilter(rate, EQBands::midFrequency, (SampleType) p.midQ, juce::Decibels::decibelsToGain((SampleType) p.midGain))),
+              high(Coefficients::makeHighShelf(rate, EQBands::highFrequency, EQBands::shelfQ, juce::Decibels::decibelsToGain((SampleType) p.highGain)))
+        {
+        }
+
+        void process(SampleType* const* channels, int numSamples)
+        {
+            juce::dsp::AudioBlock<SampleType> block(channels, 1, (size_t) numSamples);
+            juce::dsp::ProcessContextReplacing<SampleType> context(block);
+            low.process(context);
+            mid.process(context);
+            high.process(context);
+        }
+
+        juce::dsp::IIR::Filter<SampleType> low, mid, high;
+    };
+
+    // Traite data sur place ; renvoie le temps de traitement (ns)
+    using Process = std::function<double(double sampleRate, std::vector<double>& data)>;
+
+    struct Path
+    {
+        juce::String name;
+        bool precise;           // compare à la référence double (saturation)
+        double toleranceDb;     // profondeur de null minimale exigée
+        Process process;
+    };
+
+    struct Suite
+    {
+        juce::String name;
+        double amplitude;
+        bool measureMagnitude;
+        std::function<double(double sampleRate, std::vector<double>& data, bool precise)> reference;
+        std::vector<Path> paths;
+    };
+
+    template <typename SampleType>
+    Process cascadePath(std::function<BasicBiquadCoefficients<SampleType>(int band, double rate)> design)
+    {
+        return [design](double rate, std::vector<double>& data) {
+            BiquadCascade<SampleType> cascade;
+            cascade.prepare(1);
+            for (int b = 0; b < EQBands::numBands; ++b)
+                cascade.setCoefficients(b, design(b, rate));
+            return runIn<SampleType>(data, [&](SampleType* const* ch, int n) { cascade.process(ch, 1, n); });
+        };
+    }
+
+    template <typename SampleType>
+    Process stateVariablePath(const EQParameters& p)
+    {
+        return [p](double rate, std::vector<double>& data) {
+            // prepare() fige les paramètres : pas de lissage pendant la mesure
+            StateVariableEQ<SampleType> svf;
+            svf.setParameters(p);
+            svf.prepare(rate, 1);
+            return runIn<SampleType>(data, [&](SampleType* const* ch, int n) { svf.process(ch, 1, n); });
+        };
+    }
+
+    template <typename SampleType>
+    Process saturationPath(Waveshaper::Quality quality)
+    {
+        return [quality](double, std::vector<double>& data) {
+            return runIn<SampleType>(data, [&](SampleType* const* ch, int n) {
+                Waveshaper::processSoft(ch[0], n, (SampleType) Waveshaper::softDrive, quality);
+            });
+        };
+    }
+
+    Suite makeEQSuite(const EQParameters& p, const CoefficientTable& table)
+    {
+        Suite s;
+        s.name = "EQ (low " + juce::String(p.lowGain, 1) + " dB, mid " + juce::String(p.midGain, 1) + " dB Q "
+               + juce::String(p.midQ, 2) + ", high " + juce::String(p.highGain, 1) + " dB), reference juce IIR double";
+        s.amplitude = eqAmplitude;
+        s.measureMagnitude = true;
+        s.reference = [p](double rate, std::vector<double>& data, bool) {
+            JuceChain<double> chain(rate, p);
+            return runIn<double>(data, [&](double* const* ch, int n) { chain.process(ch, n); });
+        };
+        s.paths = {
+            { "juce IIR float (original)", false, -60.0, [p](double rate, std::vector<double>& data) {
+                  JuceChain<float> chain(rate, p);
+                  return runIn<float>(data, [&](float* const* ch, int n) { chain.process(ch, n); });
+              } },
+            { "fused SIMD cascade", false, -60.0,
+              cascadePath<float>([p](int b, double rate) { return EQDesign::makeBand(b, rate, p); }) },
+            { "cascade, cached table coeffs", false, -40.0,
+              cascadePath<float>([p, &table](int b, double rate) { return table.makeBand(b, rate, p); }) },
+            { "state variable float", false, -60.0, stateVariablePath<float>(p) },
+            { "fused cascade double", true, -120.0,
+              cascadePath<double>([p](int b, double rate) { return EQDesign::makeBandPrecise(b, rate, p); }) },
+            { "state variable double", true, -120.0, stateVariablePath<double>(p) },
+        };
+        return s;
+    }
+
+    Suite makeSaturationSuite()
+    {
+        Suite s;
+        s.name = "saturation tanh(x * " + juce::String(Waveshaper::softDrive, 1) + "), reference softSaturation (libm)";
+        s.amplitude = saturationAmplitude;
+        s.measureMagnitude = false;
+        s.reference = [](double, std::vector<double>& data, bool precise) {
+            if (precise)
+                return runIn<double>(data, [](double* const* ch, int n) {
+                    for (int i = 0; i < n; ++i)
+                        ch[0][i] = std::tanh(ch[0][i] * (double) Waveshaper::softDrive);
+                });
+            return runIn<float>(data, [](float* const* ch, int n) {
+                for (int i = 0; i < n; ++i)
+                    ch[0][i] = Waveshaper::softSaturation(ch[0][i]);
+            });
+        };
+        s.paths = {
+            { "tanh exact float", false, -120.0, saturationPath<float>(Waveshaper::Quality::exact) },
+            { "tanh high float (7/6)", false, -70.0, saturationPath<float>(Waveshaper::Quality::high) },
+            { "tanh fast float (3/2)", false, -25.0, saturationPath<float>(Waveshaper::Quality::fast) },
+            { "tanh exact double", true, -200.0, saturationPath<double>(Waveshaper::Quality::exact) },
+            { "tanh high double (7/6)", true, -70.0, saturationPath<double>(Waveshaper::Quality::high) },
+            { "tanh fast double (3/2)", true, -25.0, saturationPath<double>(Waveshaper::Quality::fast) },
+        };
+        return s;
+    }
+
+    struct Comparison
+    {
+        double maxError = 0.0;
+        double nullDb = nullFloorDb;
+    };
+
+    Comparison compare(const std::vector<double>& reference, const std::vector<double>& output)
+    {
+        Comparison c;
+        double errorEnergy = 0.0, referenceEnergy = 0.0;
+        for (size_t i = 0; i < reference.size(); ++i) {
+            const double e = output[i] - reference[i];
+            c.maxError = juce::jmax(c.maxError, std::abs(e));
+            errorEnergy += e * e;
+            referenceEnergy += reference[i] * reference[i];
+        }
+        if (errorEnergy > 0.0 && referenceEnergy > 0.0)
+            c.nullDb = juce::jmax(nullFloorDb, 10.0 * std::log10(errorEnergy / referenceEnergy));
+        return c;
+    }
+
+    // |H(f)| en dB depuis la réponse à une impulsion d'amplitude amplitude
+    double magnitudeDb(const std::vector<double>& impulseResponse, double amplitude, double frequency, double sampleRate)
+    {
+        const double w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+        std::complex<double> sum;
+        for (size_t n = 0; n < impulseResponse.size(); ++n)
+            sum += impulseResponse[n] * std::polar(1.0, -w * (double) n);
+        return juce::Decibels::gainToDecibels(std::abs(sum) / amplitude, nullFloorDb);
+    }
+
+    juce::String formatDb(double db)
+    {
+        return (db > 0.0 ? "+" : "") + juce::String(db, 2);
+    }
+}
+
+int runVerifyBench(const juce::StringArray& args)
+{
+    const auto options = parseArgs(args);
+
+    // Tables partagées construites en tâche de fond : on attend celles des fréquences testées
+    juce::SharedResourcePointer<CoefficientTable> table;
+    for (auto rate : sampleRates) {
+        table->prepare(rate);
+        for (int waited = 0; !table->isReady(rate) && waited < 30000; waited += 10)
+            juce::Thread::sleep(10);
+        if (!table->isReady(rate))
+            std::cout << "warning: coefficient table for " << rate << " Hz not ready, direct design used" << std::endl;
+    }
+
+    std::vector<Suite> suites { makeEQSuite(testParameters, *table), makeSaturationSuite() };
+
+    juce::Array<juce::var> jsonResults, jsonMagnitudes;
+    int failures = 0;
+
+    std::cout << "MerjEQBench verification, " << options.seconds << " s per signal" << std::endl;
+
+    for (auto& suite : suites) {
+        for (auto rate : sampleRates) {
+            const int numSamples = juce::jmax(1, (int) (options.seconds * rate));
+            const auto signals = makeSignals(rate, numSamples, suite.amplitude, suite.measureMagnitude);
+
+            // Référence calculée une fois par signal et par précision
+            std::vector<std::vector<double>> references[2];
+            std::vector<double> referenceNs[2];
+            for (int precise = 0; precise < 2; ++precise)
+                for (auto& signal : signals) {
+                    auto data = signal.samples;
+                    referenceNs[precise].push_back(suite.reference(rate, data, precise != 0) / numSamples);
+                    references[precise].push_back(std::move(data));
+                }
+
+            std::cout << std::endl << "== " << suite.name << ", " << rate << " Hz" << std::endl;
+            std::cout << "path                            signal      max error    null dB   ref ns/smp   ns/smp  verdict" << std::endl;
+
+            std::vector<std::pair<juce::String, const std::vector<double>*>> impulseResponses;
+            std::vector<std::vector<double>> pathImpulses;
+            pathImpulses.reserve(suite.paths.size());
+
+            for (auto& path : suite.paths) {
+                const int p = path.precise ? 1 : 0;
+                for (size_t s = 0; s < signals.size(); ++s) {
+                    auto data = signals[s].samples;
+                    const double ns = path.process(rate, data) / numSamples;
+                    const auto c = compare(references[p][s], data);
+                    const bool pass = c.nullDb <= path.toleranceDb;
+                    failures += pass ? 0 : 1;
+
+                    std::cout << path.name.paddedRight(' ', 32)
+                              << signals[s].name.paddedRight(' ', 9)
+                              << juce::String(c.maxError, 3, true).paddedLeft(' ', 12)
+                              << juce::String(c.nullDb, 1).paddedLeft(' ', 11)
+                              << juce::String(referenceNs[p][s], 2).paddedLeft(' ', 13)
+                              << juce::String(ns, 2).paddedLeft(' ', 9)
+                              << (pass ? "  ok" : "  FAIL (" + juce::String(path.toleranceDb, 0) + " dB)") << std::endl;
+
+                    auto* obj = new juce::DynamicObject();
+                    obj->setProperty("suite", suite.name);
+                    obj->setProperty("sampleRate", rate);
+                    obj->setProperty("path", path.name);
+                    obj->setProperty("signal", signals[s].name);
+                    obj->setProperty("maxError", c.maxError);
+                    obj->setProperty("nullDb", c.nullDb);
+                    obj->setProperty("toleranceDb", path.toleranceDb);
+                    obj->setProperty("referenceNsPerSample", referenceNs[p][s]);
+                    obj->setProperty("nsPerSample", ns);
+                    obj->setProperty("pass", pass);
+                    jsonResults.add(juce::var(obj));
+
+                    if (suite.measureMagnitude && signals[s].name == "impulse")
+                        pathImpulses.push_back(std::move(data));
+                }
+            }
+
+            if (!suite.measureMagnitude)
+                continue;
+
+            // Amplitude aux fréquences des bandes : référence puis chaque chemin
+            impulseResponses.push_back({ "reference (juce IIR double)", &references[1].back() });
+            for (size_t i = 0; i < pathImpulses.size(); ++i)
+                impulseResponses.push_back({ suite.paths[i].name, &pathImpulses[i] });
+
+            std::cout << "magnitude dB                      200 Hz     4 kHz    12 kHz" << std::endl;
+            for (auto& [name, response] : impulseResponses) {
+                std::cout << name.paddedRight(' ', 32);
+                auto* obj = new juce::DynamicObject();
+                obj->setProperty("sampleRate", rate);
+                obj->setProperty("path", name);
+                for (auto f : probeFrequencies) {
+                    const double db = magnitudeDb(*response, suite.amplitude, f, rate);
+                    std::cout << formatDb(db).paddedLeft(' ', 10);
+                    obj->setProperty(juce::Identifier("dB" + juce::String((int) f)), db);
+                }
+                std::cout << std::endl;
+                jsonMagnitudes.add(juce::var(obj));
+            }
+        }
+    }
+
+    if (options.jsonFile != juce::File()) {
+        auto* root = new juce::DynamicObject();
+        root->setProperty("date", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("cpu", juce::SystemStats::getCpuModel());
+        root->setProperty("secondsPerSignal", options.seconds);
+        root->setProperty("results", jsonResults);
+        root->setProperty("magnitudes", jsonMagnitudes);
+        if (!options.jsonFile.replaceWithText(juce::JSON::toString(juce::var(root)))) {
+            std::cerr << "Cannot write " << options.jsonFile.getFullPathName() << std::endl;
+            return 1;
+        }
+        std::cout << "Results written to " << options.jsonFile.getFullPathName() << std::endl;
+    }
+
+    std::cout << std::endl << (failures == 0 ? "All paths within tolerance" : juce::String(failures) + " comparison(s) out of tolerance") << std::endl;
+    return failures == 0 ? 0 : 4;
+}
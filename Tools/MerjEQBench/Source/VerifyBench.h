@@ -0,0 +1,6 @@
+#pragma once
+#include <JuceHeader.h>
+
+// Vérification numérique des chemins optimisés contre les implémentations de référence
+// (chaîne juce::dsp::IIR::Filter et softSaturation), avec les temps des deux côtés
+int runVerifyBench(const juce::StringArray& args);